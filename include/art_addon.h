@@ -3,25 +3,46 @@
  */
 #pragma once
 
+#include "mpsc_queue.h"
+
+#include <atomic>
 #include <chrono>
 #include <functional>
+#include <list>
 #include <memory>
+#include <string_view>
+#include <thread>
+#include <unordered_set>
 
 namespace art_addon
 {
 	class ArtAddon;
 	using ArtAddonPtr = std::shared_ptr<ArtAddon>;
 
+	/* Lets the model path maps be searched with a string_view without building a string */
+	struct PathHash
+	{
+		using is_transparent = void;
+		std::size_t operator()(std::string_view a_path) const
+		{
+			return std::hash<std::string_view>{}(a_path);
+		}
+	};
+
 	class ArtAddon
 	{
 		friend class ArtAddonManager;
+		friend class ArtAddonPool;
 
 	public:
 		/** Returns: shared_ptr, or nullptr if modelPath or target is invalid
 		 * 
 		 * Constructs a new ArtAddon and queues the creation of its 3D model. The model is not 
 		 * saved to the savefile but it will persist through game loads for the lifetime of the
-		 * returned pointer.
+		 * returned pointer. If the model was loaded before and this is called from the main
+		 * thread, the 3D is cloned right away and the callback runs before this returns.
+		 * Safe to call from any thread: off the main thread the model effect is applied by the
+		 * next ArtAddonManager::Update, and a target that can't take it is only logged there.
          * 
          * a_model_path:	path to the *.nif file relative to Data/meshes/
          * a_target:		object to attach the 3D to
@@ -34,18 +55,31 @@ namespace art_addon
 			RE::NiAVObject* a_attach_node, RE::NiTransform& a_local,
 			std::function<void(ArtAddon*)> a_callback = nullptr);
 
-		~ArtAddon()
-		{
-			if (root3D && target && target->Is3DLoaded() && root3D->parent)
-			{
-				root3D->parent->DetachChild(root3D);
-			}
-		}
+		/** Returns: shared_ptr, or nullptr if modelPath or target is invalid
+		 *
+		 * Same as Make, but the 3D is recycled through the ArtAddonPool. If the pool has a node for
+		 * a_model_path it is attached right away and the callback runs before this returns.
+		 * Meant for short-lived effects that are created over and over. a_model_path must
+		 * outlive the returned ArtAddon.
+		 */
+		[[nodiscard]] static ArtAddonPtr MakePooled(const char* a_model_path,
+			RE::TESObjectREFR* a_target, RE::NiAVObject* a_attach_node, RE::NiTransform& a_local,
+			std::function<void(ArtAddon*)> a_callback = nullptr);
+
+		~ArtAddon();
 
 		/** Returns: Pointer to the attached NiAVObject. nullptr if initialization hasn't finished. */
 		RE::NiAVObject* Get3D() { return root3D; }
 		RE::NiAVObject* GetParent() { return attach_node; }
 
+		/** Moves the 3D relative to the attachNode. If it hasn't been created yet, it will be
+		 * attached with this transform instead of the one passed to Make. */
+		void SetLocal(const RE::NiTransform& a_local)
+		{
+			if (root3D) { root3D->local = a_local; }
+			else { local = a_local; }
+		}
+
 	protected:
 		ArtAddon() = default;
 		ArtAddon(const ArtAddon&) = delete;
@@ -59,6 +93,44 @@ namespace art_addon
 		RE::NiAVObject*                attach_node = nullptr;
 		RE::NiTransform                local;
 		std::function<void(ArtAddon*)> callback;
+		/* set for pooled ArtAddons, the 3D goes back to the pool on destruction */
+		const char* pool_model = nullptr;
+	};
+
+	/** Spare 3D of pooled ArtAddons, per model path. Nodes are kept detached with a reference
+	 * held, so reusing one is a re-parent instead of a new ModelReferenceEffect and clone. */
+	class ArtAddonPool
+	{
+		friend ArtAddon;
+
+	public:
+		static ArtAddonPool* GetSingleton()
+		{
+			static ArtAddonPool singleton;
+			return &singleton;
+		}
+
+		/* Drops all spare nodes, called on revert */
+		void Clear() { free_nodes.clear(); }
+
+	private:
+		ArtAddonPool() = default;
+		~ArtAddonPool() = default;
+		ArtAddonPool(const ArtAddonPool&) = delete;
+		ArtAddonPool(ArtAddonPool&&) = delete;
+		ArtAddonPool& operator=(const ArtAddonPool&) = delete;
+		ArtAddonPool& operator=(ArtAddonPool&&) = delete;
+
+		/* Returns: a spare node for the model, or nullptr if there is none */
+		RE::NiPointer<RE::NiAVObject> Acquire(const char* a_model_path);
+		void Release(const char* a_model_path, RE::NiPointer<RE::NiAVObject> a_node);
+
+		/* Spare nodes kept per model, anything above is freed */
+		static constexpr std::size_t kMaxSparePerModel = 16;
+
+		std::unordered_map<std::string, std::vector<RE::NiPointer<RE::NiAVObject>>, PathHash,
+			std::equal_to<>>
+			free_nodes;
 	};
 
 	class ArtAddonManager
@@ -66,10 +138,33 @@ namespace art_addon
 		friend ArtAddon;
 
 	public:
+		/* Counters from the last call to Update. Only read them from the main thread */
+		struct UpdateStats
+		{
+			uint32_t pending = 0;
+			uint32_t effects_scanned = 0;
+			uint32_t resolved = 0;
+			uint32_t retried = 0;
+			uint32_t dropped = 0;
+		};
+
 		/** Must be called every frame. It only takes 1 frame to create all the models and remove 
-		 * them from the processing queue so this will usually do nothing. */
+		 * them from the processing queue so this will usually do nothing.
+		 *
+		 * The model effect scan stops as soon as every pending ArtAddon has been found. Ones that
+		 * still haven't shown up after kRetryFrames are applied again, up to kMaxRetries times.
+		 *
+		 * ArtAddons can be made from any thread, but Update must always be called from the same
+		 * one (the main thread).
+		 */
 		void Update();
 
+		const UpdateStats& GetStats() const { return stats; }
+
+		/* Creates the art form for a model ahead of time, so the first ArtAddon using it
+		 * doesn't have to. Call after kDataLoaded */
+		void Preload(std::string_view a_model_path) { GetArtForm(a_model_path); }
+
 		static ArtAddonManager* GetSingleton()
 		{
 			static ArtAddonManager singleton;
@@ -84,14 +179,76 @@ namespace art_addon
 		ArtAddonManager& operator=(const ArtAddonManager&) = delete;
 		ArtAddonManager& operator=(ArtAddonManager&&) = delete;
 
-		RE::BGSArtObject* GetArtForm(const char* a_modelPath);
+		/* Pushed by ArtAddon::Make on any thread */
+		struct CreateRequest
+		{
+			int                     id;
+			RE::BGSArtObject*       art_object;
+			std::weak_ptr<ArtAddon> addon;
+			bool                    applied;  // false if Update still has to apply the effect
+		};
+
+		struct PendingAddon
+		{
+			std::weak_ptr<ArtAddon> addon;
+			uint32_t                frames_waiting = 0;
+			uint32_t                retries = 0;
+		};
+
+		struct CachedArtForm
+		{
+			RE::BGSArtObject*                       form;
+			std::list<const std::string*>::iterator lru;  // position in artobject_lru
+			uint32_t                                last_used;
+		};
+
+		static constexpr uint32_t kRetryFrames = 90;
+		static constexpr uint32_t kMaxRetries = 3;
+
+		/* Art forms are duplicated forms that live until the game exits. Beyond this many, the
+		 * form least recently looked up by GetArtForm is given the new model instead, if it
+		 * hasn't been looked up for kRecycleFrames. Only lookups count: a model that is still on
+		 * screen but wasn't requested again can lose its form, which is harmless since its 3D
+		 * was already cloned. The cache grows past this only while more than kMaxArtForms
+		 * models are looked up within kRecycleFrames */
+		static constexpr std::size_t kMaxArtForms = 256;
+		static constexpr uint32_t    kRecycleFrames = 900;
+
+		/* Returns: the art form for the model, creating or recycling one if needed. Thread safe */
+		RE::BGSArtObject* GetArtForm(std::string_view a_model_path);
+
+		/* Returns: the loaded copy of the model to clone from, or nullptr if there is none yet or
+		 * this isn't the thread that runs Update */
+		RE::NiAVObject* GetMaster(std::string_view a_model_path);
 		int               GetNextId();
 
-		std::unordered_map<int, std::weak_ptr<ArtAddon>>   new_objects;
-		std::mutex                                         objects_lock;
-		std::unordered_map<const char*, RE::BGSArtObject*> artobject_cache;
-		RE::BGSArtObject*                                  base_artobject;
-		int                                                next_id = -2;
+		/* Returns: true on the thread that runs Update */
+		bool IsMainThread() const;
+
+		/* Ages the pending ArtAddons that weren't found this frame, retrying or dropping them */
+		void AgePending();
+
+		helper::MPSCQueue<CreateRequest> requests;
+
+		/* Only touched by Update. own_artobjects holds every art form that has been requested,
+		 * superseded_ids the IDs of attempts that were retried */
+		std::unordered_map<int, PendingAddon>       new_objects;
+		std::unordered_set<const RE::BGSArtObject*> own_artobjects;
+		std::unordered_set<int>                     superseded_ids;
+		UpdateStats                                 stats;
+
+		/* One detached copy of every model that has been loaded, kept by the thread that runs
+		 * Update. Capped at kMaxArtForms models */
+		std::unordered_map<std::string, RE::NiPointer<RE::NiAVObject>, PathHash, std::equal_to<>>
+			masters;
+		std::atomic<std::thread::id> main_thread;
+
+		std::mutex cache_lock;
+		std::unordered_map<std::string, CachedArtForm, PathHash, std::equal_to<>> artobject_cache;
+		std::list<const std::string*> artobject_lru;  // cache keys, most recently used first
+		RE::BGSArtObject*             base_artobject;
+		std::atomic<int>              next_id = -2;
+		std::atomic<uint32_t>         frame = 0;
 	};
 
 	class NifChar
@@ -2,11 +2,26 @@
 #include "NiVectorExtraData.h"
 #include "animations.h"
 #include "art_addon.h"
+#include "bounds_cache.h"
+#include "bvh.h"
+#include "form_info.h"
 #include "helper_game.h"
 #include "higgsinterface001.h"
+#include "id_allocator.h"
+#include "inventory_mirror.h"
+#include "layout_table.h"
 #include "main_plugin.h"
+#include "occupancy_grid.h"
+#include "proximity_scheduler.h"
+#include "ring_buffer.h"
+#include "slot_bitmap.h"
 #include "vrinput.h"
 
+#include <bitset>
+#include <chrono>
+#include <optional>
+#include <variant>
+
 namespace backpack
 {
 	const std::string g_mod_name = "BackpackVR.esp";
@@ -25,6 +40,7 @@ namespace backpack
 	class Backpack;
 	class Item;
 	class View;
+	class NormalView;
 
 	enum class HandState
 	{
@@ -34,6 +50,23 @@ namespace backpack
 		kGrabbing
 	};
 
+	/* Per-frame snapshot of the player's hands. Built once at the start of PostWandUpdate so the
+	 * skeleton and HIGGS are only queried once per hand per frame */
+	struct FrameInput
+	{
+		struct Hand
+		{
+			RE::NiAVObject*    node = nullptr;
+			RE::NiPoint3       position;  // palm position, HIGGS palm offset applied
+			RE::NiMatrix3      rotation;
+			HandState          state = HandState::kInvalid;
+			RE::TESObjectREFR* grabbed = nullptr;
+			float              trigger = 0;
+		};
+
+		Hand hands[2];  // indexed by isLeft
+	};
+
 	struct NewItemEvent
 	{
 		RE::NiTransform local;
@@ -41,19 +74,38 @@ namespace backpack
 		int             itemCount;
 		uint16_t        ID;
 		bool            isLeft;
+		uint32_t        expiry_frame;  // dropped if the item hasn't arrived by then
 	};
 
-	class UIEvent
+	/* Where an Item lives: the View that owns it and its handle in that View */
+	struct ItemRef
+	{
+		RE::ExtraDataList* extra = nullptr;
+		View*              view = nullptr;
+		uint32_t           handle = 0;
+	};
+
+	/* Index of a Backpack's Items by base object, so container changes find the affected Items
+	 * without scanning every View. There are rarely more than a few stacks of the same base, so
+	 * each base keeps a short list */
+	class ItemIndex
 	{
 	public:
-		enum class Type
+		void Add(RE::FormID a_base, const ItemRef& a_ref) { by_base[a_base].push_back(a_ref); }
+
+		void Remove(RE::FormID a_base, const View* a_view, uint32_t a_handle);
+
+		/* Returns: every Item with the given base, or nullptr if there are none */
+		const std::vector<ItemRef>* Find(RE::FormID a_base) const
 		{
-			ViewHovered,
-			CreateExtraDataEvent,
-			ItemHovered
-		};
-		virtual Type type() = 0;
-		virtual ~UIEvent() = default;
+			auto it = by_base.find(a_base);
+			return it != by_base.end() ? &it->second : nullptr;
+		}
+
+		void Clear() { by_base.clear(); }
+
+	private:
+		std::unordered_map<RE::FormID, std::vector<ItemRef>> by_base;
 	};
 
 	class Item
@@ -66,18 +118,70 @@ namespace backpack
 			kActive
 		};
 
+		/* How much of the Item is drawn. Full shows the inventory model, Proxy hides it behind a
+		 * small marker and Culled draws nothing */
+		enum class LOD
+		{
+			kFull,
+			kProxy,
+			kCulled
+		};
+
+		/* Bits of Item::categories. The low bits are the kind of form, exactly one is set. The
+		 * high bits are flags from the extra data */
+		struct Category
+		{
+			static constexpr uint32_t kWeapon = 1 << 0;
+			static constexpr uint32_t kArmor = 1 << 1;
+			static constexpr uint32_t kPotion = 1 << 2;  // includes food and poison
+			static constexpr uint32_t kIngredient = 1 << 3;
+			static constexpr uint32_t kBook = 1 << 4;
+			static constexpr uint32_t kScroll = 1 << 5;
+			static constexpr uint32_t kAmmo = 1 << 6;
+			static constexpr uint32_t kKey = 1 << 7;
+			static constexpr uint32_t kSoulGem = 1 << 8;
+			static constexpr uint32_t kMisc = 1 << 9;
+			static constexpr uint32_t kAnyType = (1 << 10) - 1;
+
+			static constexpr uint32_t kEquipped = 1 << 16;
+			// Only refreshed on equip events: favoriting in the inventory menu sends no event,
+			// so the flag can be stale until the backpack is opened again
+			static constexpr uint32_t kFavorite = 1 << 17;
+			static constexpr uint32_t kQuest = 1 << 18;
+			static constexpr uint32_t kStolen = 1 << 19;
+		};
+
+		static constexpr const char* kProxyModel = "HelperSphere.nif";
+		static constexpr float       kProxyScale = 0.3f;
+
 		Item(RE::TESBoundObject* base, int count, RE::ExtraDataList* extradata,
 			art_addon::ArtAddonPtr model) :
 			base(base),
 			count(count),
 			extradata(extradata),
-			model(model){};
+			model(model),
+			categories(ComputeCategories(base, extradata)){};
+
+		static uint32_t ComputeCategories(RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra);
+
+		/* Must be called when the Item is equipped, favorited etc. */
+		void UpdateCategories() { categories = ComputeCategories(base, extradata); }
 
 		State GetState(bool isLeft) const { return state[isLeft]; }
 		/* Sets the state for the given hand. Also checks if a state change event should be sent */
 		void SetState(bool isLeft, State a_new_state);
 
-		float CheckOverlap(const RE::NiPoint3& a_world_pos);
+		/* Returns: the model's bounding sphere in the local space of a_view_root, or a sphere with
+		 * radius 0 if the model isn't loaded yet */
+		bvh::Sphere GetViewBound(const RE::NiAVObject* a_view_root) const;
+
+		/* Adds the model's bounds to the ModelBoundsCache if they aren't there yet. Needs the 3D */
+		void RecordModelBounds() const;
+
+		/* Hides or shows the model and creates or releases the proxy. The model stays loaded so
+		 * going back to full detail is instant.
+		 * Returns: false if the model isn't loaded yet and the LOD couldn't be applied */
+		bool SetLOD(LOD a_lod, RE::NiAVObject* a_view_root);
 
 		RE::TESBoundObject*                 base;
 		int                                 count;
@@ -85,6 +189,26 @@ namespace backpack
 		art_addon::ArtAddonPtr              model;
 		std::vector<art_addon::ArtAddonPtr> effects;
 		State                               state[2] = { State::kIdle };
+		uint32_t                            handle = 0;  // assigned by the View, never reused
+		LOD                                 lod = LOD::kFull;
+		art_addon::ArtAddonPtr              proxy;
+		uint32_t                            categories = 0;
+		bool                                filtered_out = false;
+	};
+
+	/* Filter over Item::categories. An Item matches if it has any of the any bits, all of the
+	 * required bits and none of the excluded bits. The default matches everything */
+	struct ItemFilter
+	{
+		uint32_t any = Item::Category::kAnyType;
+		uint32_t required = 0;
+		uint32_t excluded = 0;
+
+		bool Matches(uint32_t a_categories) const
+		{
+			return (a_categories & any) && (a_categories & required) == required &&
+				!(a_categories & excluded);
+		}
 	};
 
 	class View
@@ -103,14 +227,27 @@ namespace backpack
 			kShow
 		};
 
-		View(RE::NiAVObject* root) : root(root){};
+		/* Bit per View class, see FormInfo::view_mask */
+		struct Type
+		{
+			static constexpr uint32_t kNormal = 1 << 0;
+			static constexpr uint32_t kGrid = 1 << 1;
+			static constexpr uint32_t kHolster = 1 << 2;
+			static constexpr uint32_t kHandle = 1 << 3;
+		};
+
+		View(RE::NiAVObject* root, uint32_t a_type) : root(root), type(a_type){};
 		virtual ~View() = default;
 		View(const View&) = delete;
 		View& operator=(const View&) = delete;
 		View(View&&) = default;
 		View& operator=(View&&) = default;
 
-		virtual bool CanAcceptObject(RE::TESBoundObject* a_obj) = 0;
+		/* Looked up in the FormInfoCache, each View class decides in its static Accepts */
+		bool CanAcceptObject(RE::TESBoundObject* a_obj)
+		{
+			return FormInfoCache::GetSingleton()->Get(a_obj).view_mask & type;
+		}
 
 		virtual const char* GetName() = 0;
 
@@ -119,27 +256,96 @@ namespace backpack
 
 		virtual bool IsHandle() { return false; }
 
-		bool AddItem(const Item& a_item)
+		/* Items added to the View are registered in a_index until it is reset */
+		void SetIndex(ItemIndex* a_index) { index = a_index; }
+
+		/* Stored Item transforms are read from a_layout */
+		void SetLayout(const LayoutTable* a_layout) { layout = a_layout; }
+
+		/* Returns: where the stack was placed in the View, from the layout table or from the
+		 * extra data older versions wrote. nullopt if it was never placed */
+		std::optional<RE::NiTransform> GetStoredTransform(
+			RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra) const;
+
+		/* Item poses are kept relative to the View's extent, see helper::CompactPose */
+		helper::CompactPose PackPose(const RE::NiTransform& a_local) const
+		{
+			return helper::PackPose(a_local, GetPoseRange());
+		}
+		RE::NiTransform UnpackPose(const helper::CompactPose& a_pose) const
 		{
-			items.push_back(a_item);
-			return true;
+			return helper::UnpackPose(a_pose, GetPoseRange());
 		}
 
+		virtual bool AddItem(const Item& a_item);
+
 		virtual bool AddItemEx(RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra, int count);
 
+		/* Removes the Item if it belongs to this View. Item pointers into this View are
+		 * invalidated, since the last Item is moved into the freed slot */
 		void Remove(Item* a_item)
 		{
-			auto it = std::find_if(
-				items.begin(), items.end(), [a_item](Item& each) { return &each == a_item; });
-			if (it != items.end()) { items.erase(it); }
+			auto it = slots.find(a_item->handle);
+			if (it != slots.end() && &items[it->second] == a_item) { Remove(a_item->handle); }
+		}
+
+		virtual void Remove(uint32_t a_handle);
+
+		/* Returns: the Item with the given handle, or nullptr if it isn't in this View */
+		Item* GetItem(uint32_t a_handle)
+		{
+			auto it = slots.find(a_handle);
+			return it != slots.end() ? &items[it->second] : nullptr;
+		}
+
+		/* Returns: the "extent" extra data of a View node, nullopt if it has none */
+		static std::optional<RE::NiPoint3> ReadExtent(RE::NiAVObject* a_root)
+		{
+			auto data =
+				a_root->GetExtraData<RE::NiVectorExtraData>(g_backpack_container_extentname);
+			if (!data) { return std::nullopt; }
+			return RE::NiPoint3(data->m_vector[0], data->m_vector[1], data->m_vector[2]);
 		}
 
-		/* Uses Alpha property to show all Items that match the filter and hide those that don't */
-		virtual void Filter(std::function<bool(const RE::TESBoundObject*)> filter);
+		/* Must be called after an Item's model is moved inside the View, so picking sees it */
+		void NotifyItemMoved() { items_moved = true; }
 
+		/* Uses Alpha property to show all Items that match the filter and hide those that don't.
+		 * The models are updated in the next ApplyFilter */
+		void Filter(const ItemFilter& a_filter)
+		{
+			filter = a_filter;
+			RefreshFilter();
+		}
+
+		/* Re-evaluates the current filter, e.g. after Item categories changed */
+		void RefreshFilter()
+		{
+			filter_dirty = true;
+			filter_retries = 0;
+		}
+
+		/* Sets the alpha of the Items whose filter result changed since the last pass. Items
+		 * with a model that is still loading are retried on the next calls, for a while. Items
+		 * without a model are skipped */
+		void ApplyFilter();
+
+		/* Shows every Item at full detail, or culls them all. A hidden View stays culled until
+		 * it is shown again, whatever LOD the backpack picks */
 		void ToggleVisible(bool a_visible);
 
-		Item* PickActiveItem(const RE::NiPoint3& a_world_pos, bool isLeft);
+		/* Applies a_lod to every Item, or culls them if the View is hidden. Items whose model is
+		 * still loading get it once the model shows up, as long as this keeps being called */
+		void SetLOD(Item::LOD a_lod);
+
+		/** Determines which Items each hand is touching and sets their states, dispatching
+		 * OnItemStateChange events. Both hands are handled in a single pass.
+		 *
+		 * a_world_pos:	hand positions, indexed by isLeft
+		 * a_hand_mask:	bit 0 for the right hand, bit 1 for the left. Only the enabled hands are
+		 * 				picked, the other hand's Items are left alone
+		 */
+		void PickActiveItems(const RE::NiPoint3 (&a_world_pos)[2], uint32_t a_hand_mask);
 
 		Item* GetActiveItem(bool isLeft);
 
@@ -155,12 +361,57 @@ namespace backpack
 		float CheckOverlap(const RE::NiPoint3& a_world_pos);
 
 	protected:
+		/* Brings the cached view-local Item bounds and the picking tree up to date */
+		void UpdateItemBounds();
+
+		/* Called for every Item bound that changed. A radius of 0 means no bound, e.g. the Item
+		 * was added or removed, or its model isn't loaded */
+		virtual void OnItemBoundChanged(const bvh::Sphere& a_old, const bvh::Sphere& a_new) {}
+
+		/* Twice the farthest bound on each axis, Items can hang out of the View a bit */
+		RE::NiPoint3 GetPoseRange() const
+		{
+			auto range = [](float a_min, float a_max) {
+				return std::max({ std::abs(a_min), std::abs(a_max), 1.f }) * 2.f;
+			};
+			return { range(min_bound.x, max_bound.x), range(min_bound.y, max_bound.y),
+				range(min_bound.z, max_bound.z) };
+		}
+
 		std::vector<Item> items;
 		RE::NiAVObject*   root;
+		uint32_t          type;
 		State             state[2] = { State::kIdle };
 		VisibleState      visibility = VisibleState::kShow;
 		RE::NiPoint3      min_bound;
 		RE::NiPoint3      max_bound;
+
+		/* Hot picking data, kept apart from the Items so the per-frame pass doesn't touch them.
+		 * item_bounds is indexed the same as items, item_tree packs them for the SIMD test */
+		std::vector<bvh::Sphere>                item_bounds;
+		bvh::SphereTree                         item_tree;
+		std::vector<uint32_t>                   picked[2];
+		std::vector<std::pair<float, uint32_t>> narrow[2];
+		int                                     unresolved_bounds = 0;
+		bool                                    items_changed = false;
+		bool                                    items_moved = false;
+
+		std::unordered_map<uint32_t, uint32_t> slots;  // Item handle -> index in items
+		uint32_t                               next_handle = 1;
+		ItemIndex*                             index = nullptr;
+		const LayoutTable*                     layout = nullptr;
+
+		Item::LOD lod = Item::LOD::kFull;
+		bool      lod_pending = false;  // some Items don't have the View's LOD yet
+
+		static constexpr float kFilteredAlpha = 0.f;
+
+		/* About 5 seconds at 90 Hz, a model that hasn't loaded by then was dropped */
+		static constexpr uint32_t kFilterRetryFrames = 450;
+
+		ItemFilter filter;
+		bool       filter_dirty = false;
+		uint32_t   filter_retries = 0;
 	};
 
 	class GridView : public View
@@ -169,14 +420,16 @@ namespace backpack
 		static constexpr const char* kNodeName = "Grid";
 		const char*                  GetName() { return kNodeName; }
 
-		GridView(RE::NiAVObject* root) : View(root)
+		/* a_extent is read from the node if not given */
+		GridView(RE::NiAVObject* root, std::optional<RE::NiPoint3> a_extent = std::nullopt) :
+			View(root, Type::kGrid)
 		{
-			if (auto extents =
-					root->GetExtraData<RE::NiVectorExtraData>(g_backpack_container_extentname))
+			if (auto extents = a_extent ? a_extent : ReadExtent(root))
 			{
 				min_bound = { 0, 0, 0 };
-				max_bound = { extents->m_vector[0], extents->m_vector[1], extents->m_vector[2] };
+				max_bound = *extents;
 			}
+			CalculateGridLayout();
 			SKSE::log::trace("grid created");
 		}
 
@@ -188,23 +441,48 @@ namespace backpack
 			float items_per_column = 0;
 			float vertical_spacing = 0;
 		};
-		bool CanAcceptObject(RE::TESBoundObject* a_obj);
+		static bool Accepts(RE::TESBoundObject* a_obj);
 
+		/* Returns: the view-local position the next added Item will be placed at */
 		RE::NiPoint3 FindNextAvailableSlot(RE::TESBoundObject* a_inventory_item)
 		{
-			return { 0, 0, 0 };
+			return GetSlotPosition(occupied.FirstFree());
 		}
 
-		void Filter(std::function<bool(const RE::TESBoundObject*)> filter) override;
-
 		bool InventoryAddObject(RE::TESObjectREFR* a_obj, RE::TESObjectREFR* a_wearer, bool isLeft);
 
+		/* Places the Item in the first free grid slot. Fails if the grid is full */
+		bool AddItem(const Item& a_item) override;
+
+		/* Only takes Items that don't have a position stored in their extra data. Once the grid
+		 * is full they go to the overflow View instead */
 		bool AddItemEx(RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra, int count) override;
 
+		/* Returns: how many slots fit in the grid's extent with the current layout */
+		uint32_t GetCapacity() const;
+
+		/* Where Items go that don't fit in the grid, nullptr to drop them */
+		void SetOverflow(NormalView* a_view) { overflow = a_view; }
+
+		/* The Item in the last grid slot is moved into the freed one, so the grid stays packed
+		 * and at most one other Item has to move */
+		void Remove(uint32_t a_handle) override;
+		using View::Remove;
+
+		/* Recomputes the grid metrics and moves every Item if they changed */
 		void CalculateGridLayout();
 
 	private:
-		GridLayout mini_layout;
+		RE::NiPoint3 GetSlotPosition(uint32_t a_slot) const;
+
+		void PlaceItem(Item& a_item, uint32_t a_slot);
+
+		GridLayout         mini_layout;
+		helper::SlotBitmap occupied;
+		NormalView*        overflow = nullptr;
+
+		std::vector<uint32_t>                  slot_items;  // grid slot -> Item handle, 0 if free
+		std::unordered_map<uint32_t, uint32_t> grid_slots;  // Item handle -> grid slot
 	};
 
 	class NormalView : public View
@@ -213,40 +491,53 @@ namespace backpack
 		static constexpr const char* kNodeName = "Container";
 		const char*                  GetName() { return kNodeName; }
 
-		NormalView(RE::NiAVObject* root) : View(root)
+		/* a_extent is read from the node if not given */
+		NormalView(RE::NiAVObject* root, std::optional<RE::NiPoint3> a_extent = std::nullopt) :
+			View(root, Type::kNormal)
 		{
-			if (auto extents =
-					root->GetExtraData<RE::NiVectorExtraData>(g_backpack_container_extentname))
+			if (auto extents = a_extent ? a_extent : ReadExtent(root))
 			{
 				min_bound = { 0, 0, 0 };
-				max_bound = { extents->m_vector[0], extents->m_vector[1], extents->m_vector[2] };
+				max_bound = *extents;
 			}
 			SKSE::log::trace("{} view created with extents: {} {} {}", GetName(), max_bound.x,
 				max_bound.y, max_bound.z);
+			occupancy.Reset(min_bound, max_bound);
 		}
 
 		static bool Has3DPosition(RE::TESBoundObject* a_inventory_item) { return false; }
 
-		RE::NiPoint3 FindNextAvailableSlot(RE::TESBoundObject* a_inventory_item)
+		/* Adds an Item that has no stored position at FindNextAvailableSlot */
+		bool AddUnplacedItem(RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra, int count);
+
+		/* Returns: the free spot closest to the bottom center of the View that fits the item.
+		 * The bottom center if the View is too full */
+		RE::NiPoint3 FindNextAvailableSlot(RE::TESBoundObject* a_inventory_item);
+
+		static bool Accepts(RE::TESBoundObject* a_obj);
+
+	protected:
+		void OnItemBoundChanged(const bvh::Sphere& a_old, const bvh::Sphere& a_new) override
 		{
-			return { 0, 0, 0 };
+			occupancy.Remove(a_old);
+			occupancy.Add(a_new);
 		}
 
-		bool CanAcceptObject(RE::TESBoundObject* a_obj);
+	private:
+		helper::OccupancyGrid occupancy;
 	};
 
 	class Holster : public View
 	{
 	public:
-		Holster(RE::NiAVObject* root) : View(root)
+		/* a_extent is read from the node if not given */
+		Holster(RE::NiAVObject* root, std::optional<RE::NiPoint3> a_extent = std::nullopt) :
+			View(root, Type::kHolster)
 		{
-			if (auto extents =
-					root->GetExtraData<RE::NiVectorExtraData>(g_backpack_container_extentname))
+			if (auto extents = a_extent ? a_extent : ReadExtent(root))
 			{
-				min_bound = { extents->m_vector[0] / -2, extents->m_vector[1] / -2,
-					extents->m_vector[2] / -2 };
-				max_bound = { extents->m_vector[0] / 2, extents->m_vector[1] / 2,
-					extents->m_vector[2] / 2 };
+				min_bound = *extents / -2;
+				max_bound = *extents / 2;
 			}
 			SKSE::log::trace("{} view created with extents: {} {} {} , {} {} {}", GetName(),
 				min_bound.x, min_bound.y, min_bound.z, max_bound.x, max_bound.y, max_bound.z);
@@ -257,7 +548,7 @@ namespace backpack
 		static constexpr const char* kNodeName = "Holster";
 		const char*                  GetName() { return kNodeName; }
 
-		bool CanAcceptObject(RE::TESBoundObject* a_obj);
+		static bool Accepts(RE::TESBoundObject* a_obj);
 	};
 
 	class Handle : public View
@@ -265,7 +556,7 @@ namespace backpack
 		static constexpr float kR = 3;
 
 	public:
-		Handle(RE::NiAVObject* root) : View(root)
+		Handle(RE::NiAVObject* root) : View(root, Type::kHandle)
 		{
 			min_bound = { -kR, -kR, -kR };
 			max_bound = { kR, kR, kR };
@@ -276,8 +567,6 @@ namespace backpack
 		const char*                  GetName() { return kNodeName; }
 
 		bool IsHandle() { return true; }
-
-		bool CanAcceptObject(RE::TESBoundObject* a_obj) { return false; }
 	};
 
 	class Backpack
@@ -331,7 +620,13 @@ namespace backpack
 			wearer_ref_id(other.wearer_ref_id),
 			base(other.base),
 			views(std::move(other.views)),
-			state(other.state)
+			item_index(std::move(other.item_index)),
+			inventory(std::move(other.inventory)),
+			state(other.state),
+			proximity(other.proximity),
+			spawn_jobs(std::move(other.spawn_jobs)),
+			spawn_total(other.spawn_total),
+			load_indicator(std::move(other.load_indicator))
 		{
 			other.object = nullptr;
 			other.wearer = nullptr;
@@ -347,7 +642,13 @@ namespace backpack
 				wearer_ref_id = other.wearer_ref_id;
 				base = other.base;
 				views = std::move(other.views);
+				item_index = std::move(other.item_index);
+				inventory = std::move(other.inventory);
 				state = other.state;
+				proximity = other.proximity;
+				spawn_jobs = std::move(other.spawn_jobs);
+				spawn_total = other.spawn_total;
+				load_indicator = std::move(other.load_indicator);
 
 				other.object = nullptr;
 				other.wearer = nullptr;
@@ -356,11 +657,19 @@ namespace backpack
 			return *this;
 		}
 
-		/* Initialize all the 3D data for visible backpack. Creates views and items */
+		/* Initialize all the 3D data for visible backpack. Creates the views right away and
+		 * queues the Items, which are spawned over the next frames by ContinueInit */
 		void Init();
 
 		bool IsInit() { return !views.empty(); }
 
+		/* Returns: true while Items from Init are still waiting to be spawned */
+		bool IsLoading() const { return !spawn_jobs.empty(); }
+
+		/* Spawns queued Items, nearest to the player's hands first, until a_deadline passes. At
+		 * least one Item is spawned per call so loading always progresses */
+		void ContinueInit(std::chrono::steady_clock::time_point a_deadline);
+
 		/* Searches this backpack's Views for one that is in an Active state */
 		View* GetActiveView(bool isLeft) const;
 
@@ -400,6 +709,16 @@ namespace backpack
 		/* Attempts to add an item to the currently active View and the wearer's inventory */
 		RE::TESBoundObject* GetDefaultBase() const { return base; }
 
+		/* Returns: the mirror of the wearer's inventory, seeding it on first use */
+		const InventoryMirror& GetInventory();
+
+		/* Applies a container change of the wearer to the inventory mirror. Ignored until the
+		 * mirror is seeded, since seeding reads the inventory after the change */
+		void OnInventoryChanged(RE::TESBoundObject* a_obj, int a_delta);
+
+		/* Compares the inventory mirror against the wearer's inventory, logging the differences */
+		bool DebugCheckInventory();
+
 		void MoveGrabbed();
 
 		/* Determines which view the player's hand is inside. Also sets the state of all views,
@@ -408,14 +727,29 @@ namespace backpack
 
 		void RemoveSelectedItem();
 
+		/* Refreshes the categories of the Items with base a_base, after they were equipped etc. */
+		void OnItemFlagsChanged(RE::FormID a_base);
+
+		/* Picks the level of detail for the Items from the backpack state and the distance to
+		 * the player's hands and body */
+		void UpdateLOD();
+
 		void RemoveItem(Item* a_item)
 		{
 			for (auto& v : views) { v->Remove(a_item); }
 		}
 
-		bool CheckShutoffDistance();
+		/* Removes or shrinks the Items that a container change took out of the wearer's
+		 * inventory. Must be called after the change was applied to the inventory mirror.
+		 *
+		 * Stacks are resolved by elimination: an Item whose extra data list is no longer in the
+		 * wearer's inventory entry was removed, otherwise the change came out of a stack's count
+		 */
+		void OnItemsRemoved(RE::TESBoundObject* a_obj, int a_count);
 
-		bool CheckInteractDistance();
+		/* Moves the backpack between Active, Idle and Disabled by its distance to the player.
+		 * The distance is only checked when the proximity scheduler says it's due */
+		void UpdateProximity(uint32_t a_frame);
 
 		void NotifyNewItemAdded();
 
@@ -433,13 +767,119 @@ namespace backpack
 */
 
 	private:
+		/* An inventory stack from Init whose Item hasn't been spawned yet */
+		struct SpawnJob
+		{
+			RE::TESBoundObject* obj;
+			RE::ExtraDataList*  extra;
+			int                 count;
+			float               dist_sq;  // to the nearest hand
+		};
+
+		/* Returns: estimated world position of the Item a_job will spawn, or nullopt if it
+		 * doesn't have a stored position */
+		std::optional<RE::NiPoint3> GetSpawnPosition(const SpawnJob& a_job);
+
+		void UpdateLoadIndicator();
+
+		/* Creates the View class matching the node's name, if any */
+		void AddView(RE::NiAVObject* a_node, std::optional<RE::NiPoint3> a_extent);
+
+		/* Creates the Views listed for the backpack model in the NIF index, so the 3D doesn't
+		 * have to be searched for them. Returns: false if the model isn't in the index, or the
+		 * index doesn't match the loaded 3D. No Views are created then */
+		bool AddBakedViews(RE::NiAVObject* a_root);
+
 		RE::TESObjectREFR*                 object;
 		RE::TESObjectREFR*                 wearer;
 		RE::FormID                         ref_id;
 		RE::FormID                         wearer_ref_id;
 		RE::TESBoundObject*                base;
 		std::vector<std::unique_ptr<View>> views;
-		State                              state = State::kDisabled;
+		/* On the heap so the Views' pointer to it survives the Backpack being moved */
+		std::unique_ptr<ItemIndex> item_index = std::make_unique<ItemIndex>();
+		InventoryMirror            inventory;
+		State                      state = State::kDisabled;
+		helper::ProximityScheduler proximity;
+
+		std::vector<SpawnJob>  spawn_jobs;  // sorted farthest first, the back is spawned next
+		std::size_t            spawn_total = 0;
+		art_addon::ArtAddonPtr load_indicator;
+	};
+
+	struct ViewHoverEvent
+	{
+		View::State new_state = View::State::kIdle;
+		View::State old_state = View::State::kIdle;
+		bool        isLeft = false;
+		View*       view = nullptr;
+	};
+
+	struct ItemHoverEvent
+	{
+		Item::State new_state = Item::State::kIdle;
+		Item::State old_state = Item::State::kIdle;
+		bool        isLeft = false;
+		Item*       item = nullptr;
+	};
+
+	struct CreateExtraDataEvent
+	{
+		RE::InventoryEntryData* entry = nullptr;
+		int                     count = 0;
+		helper::CompactPose     pose;
+		RE::FormID              wearer = 0;
+	};
+
+	using UIEvent = std::variant<ViewHoverEvent, ItemHoverEvent, CreateExtraDataEvent>;
+
+	/* One pass worth of UI events. Hover events for the same (Item, hand) or (View, hand) are
+	 * merged as they are added, so only the net state change is applied and transitions that
+	 * cancel out are dropped. Other events pass through in order. Never allocates */
+	class UIEventBatch
+	{
+	public:
+		static constexpr std::size_t kCapacity = 512;
+
+		void Add(const UIEvent& a_event);
+
+		void Clear()
+		{
+			count = 0;
+			received = 0;
+			live.reset();
+			stamp++;
+		}
+
+		/* Number of events passed to Add since the last Clear */
+		std::size_t Received() const { return received; }
+
+		/* Number of events left after merging */
+		std::size_t Size() const { return live.count(); }
+
+		template <typename F>
+		void ForEach(F&& a_func) const
+		{
+			for (std::size_t i = 0; i < count; i++)
+			{
+				if (live.test(i)) { a_func(events[i]); }
+			}
+		}
+
+	private:
+		struct Slot
+		{
+			uintptr_t key = 0;
+			uint32_t  index = 0;
+			uint32_t  stamp = 0;
+		};
+
+		std::array<UIEvent, kCapacity>  events;
+		std::bitset<kCapacity>          live;
+		std::array<Slot, 2 * kCapacity> slots;
+		std::size_t                     count = 0;
+		std::size_t                     received = 0;
+		uint32_t                        stamp = 1;
 	};
 
 	class Controller
@@ -458,6 +898,7 @@ namespace backpack
 			float shutoff_distance_player = 400;
 			float shutoff_distance_npc = 300;
 			float min_interaction_distance = 150;
+			float interaction_hysteresis = 20;  // how much farther an Active backpack stays active
 			float scale_big_items = 30;
 			int   mini_items_per_row = 5;
 			float mini_horizontal_spacing = 2;
@@ -468,6 +909,9 @@ namespace backpack
 			bool  newitems_drop_on_pickup = false;
 			bool  newitems_drop_paused = false;
 			bool  newitems_drop_to_ground = false;
+			int   load_budget_us = 1000;  // time per frame for spawning backpack Items
+			float lod_full_distance = 100;  // hand to backpack, for full detail while idle
+			float lod_proxy_distance = 250;  // player to backpack, beyond this Items are culled
 		};
 
 		static Controller* GetSingleton()
@@ -481,12 +925,29 @@ namespace backpack
 		void Init()
 		{
 			backpacks.clear();
-			event_queue.clear();
+			RebuildBackpackIndex();
+			event_queue.Clear();
+			pending_items.clear();
+			item_ids.Clear();
 			selected_backpack[0] = nullptr;
 			selected_backpack[1] = nullptr;
 		}
 
-		void Add(Backpack&& a_new_backpack) { backpacks.emplace_back(std::move(a_new_backpack)); }
+		void Add(Backpack&& a_new_backpack)
+		{
+			backpacks.emplace_back(std::move(a_new_backpack));
+			RebuildBackpackIndex();
+		}
+
+		/* Returns: the backpack worn by a_wearer, or nullptr. Cheap enough to call for every
+		 * container event in the game */
+		Backpack* GetBackpackByWearer(RE::FormID a_wearer)
+		{
+			if (!(watched_wearers & WatchBit(a_wearer))) { return nullptr; }
+
+			auto it = backpack_index.find(a_wearer);
+			return it != backpack_index.end() ? &backpacks[it->second] : nullptr;
+		}
 
 		const Settings& GetSettings() { return settings; }
 		Settings&       SetSettings() { return settings; }
@@ -508,26 +969,62 @@ namespace backpack
 			RE::TESBoundObject* a_to_display_on_rollover, bool isLeft);
 		void DisableActivator(Backpack* a_activation_target);
 
+		/* Remembers where an item should go once its container change event arrives. Pushing
+		 * the same (a_form, ID) again replaces the pending entry */
 		void PushNewTransform(
 			RE::NiTransform a_transform, RE::FormID a_form, int a_count, uint16_t ID, bool isLeft)
 		{
-			pending_items.push_back({ a_transform, a_form, a_count, ID, isLeft });
+			pending_items.insert_or_assign(PendingKey(a_form, ID),
+				NewItemEvent{ a_transform, a_form, a_count, ID, isLeft,
+					frame + kPendingItemFrames });
 		}
 
-		RE::NiPoint3 GetHandPosition(bool isLeft);
+		/* IDs stamped on items that are on their way into a backpack */
+		helper::IDAllocator& GetItemIDs() { return item_ids; }
+
+		/* Where the items of a_wearer's backpack were placed, kept across saves */
+		LayoutTable& GetLayout(RE::FormID a_wearer) { return layouts[a_wearer]; }
+
+		static constexpr uint32_t kSerializationID = 'BKVR';
+		static constexpr uint32_t kLayoutRecord = 'LAYT';
+		static constexpr uint32_t kLayoutVersion = 3;
+
+		/* SKSE co-save callbacks */
+		static void OnGameSaved(SKSE::SerializationInterface* a_intfc);
+		static void OnGameLoaded(SKSE::SerializationInterface* a_intfc);
+		static void OnRevert(SKSE::SerializationInterface* a_intfc);
+
+		/* Returns this frame's palm position */
+		const RE::NiPoint3& GetHandPosition(bool isLeft) const
+		{
+			return frame_input.hands[isLeft].position;
+		}
+
+		const FrameInput& GetFrameInput() const { return frame_input; }
 
 		void SendDropEvent(
 			RE::TESBoundObject* a_base_object, RE::ExtraDataList* a_extradata, int a_count);
 
 		bool      IgnoreNextContainerChange();
-		HandState GetHandState(bool isLeft);
+		HandState GetHandState(bool isLeft) const { return frame_input.hands[isLeft].state; }
 
 		template <typename EventType, typename... Args>
 		void PushUIEvent(Args&&... args)
 		{
-			event_queue.push_back(std::make_unique<EventType>(std::forward<Args>(args)...));
+			event_queue.Push(EventType{ std::forward<Args>(args)... });
 		}
 
+		struct EventStats
+		{
+			uint64_t received = 0;  // UI events queued by Views and Items
+			uint64_t applied = 0;   // UI events left after merging, which did visual work
+		};
+
+		/* Number of UI events dropped because the queue was full */
+		std::size_t GetDroppedEventCount() const { return event_queue.Overflows(); }
+
+		const EventStats& GetEventStats() const { return event_stats; }
+
 	private:
 		Controller() = default;
 		~Controller() = default;
@@ -536,10 +1033,25 @@ namespace backpack
 		Controller& operator=(const Controller&) = delete;
 		Controller& operator=(Controller&&) = delete;
 
+		/* Must be called whenever backpacks is modified */
+		void RebuildBackpackIndex();
+
+		/* One bit of a 64-bit filter. Fibonacci hashing spreads the sequential form IDs of a
+		 * plugin across all bits */
+		static uint64_t WatchBit(RE::FormID a_id)
+		{
+			return 1ull << ((a_id * 0x9E3779B97F4A7C15ull) >> 58);
+		}
+
+		void UpdateFrameInput();
 		void ProcessInput();
 		void ProcessAnimations();
 		void ProcessEvents();
 
+		void OnUIEvent(const ViewHoverEvent& e);
+		void OnUIEvent(const ItemHoverEvent& e);
+		void OnUIEvent(const CreateExtraDataEvent& e);
+
 		void SetRolloverUIPositionOverride(bool a_enable) { rollover_override = a_enable; }
 
 		void ResetRolloverPosition();
@@ -553,60 +1065,39 @@ namespace backpack
 		void DropItemToHandOrGround(RE::TESBoundObject* a_base_object,
 			RE::ExtraDataList* a_extradata, int a_count, bool a_hardcore);
 
-		std::vector<Backpack>                backpacks;
-		Settings                             settings;
-		std::deque<std::unique_ptr<UIEvent>> event_queue;
+		std::vector<Backpack>                       backpacks;
+		std::unordered_map<RE::FormID, std::size_t> backpack_index;  // wearer -> backpacks index
+		uint64_t                                    watched_wearers = 0;
+		Settings                                    settings;
+		FrameInput                                  frame_input;
+		uint32_t                                    frame = 0;
+
+		/* Large enough for a hand sweeping through a full View in one frame. Events that don't fit
+		 * are dropped and counted */
+		static constexpr std::size_t                 kEventQueueSize = UIEventBatch::kCapacity;
+		helper::RingBuffer<UIEvent, kEventQueueSize> event_queue;
+		UIEventBatch                                 event_batch;
+		EventStats                                   event_stats;
 
 		bool                   rollover_override;
 		Backpack*              selected_backpack[2] = { nullptr };
 		bool                   ignore_next_container_add_event = false;
 		art_addon::ArtAddonPtr hand_effect[2];
 
-		std::vector<NewItemEvent> pending_items;
-	};
+		static uint64_t PendingKey(RE::FormID a_form, uint16_t a_ID)
+		{
+			return (uint64_t)a_form << 16 | a_ID;
+		}
 
-	class ViewHoverEvent : public UIEvent
-	{
-	public:
-		ViewHoverEvent(View::State new_state, bool isLeft, View* view) :
-			new_state(new_state),
-			isLeft(isLeft),
-			view(view)
-		{}
-		View::State new_state;
-		bool        isLeft;
-		View*       view;
-		Type        type() { return Type::ViewHovered; }
-	};
+		/* Releases the IDs of pending items that never arrived */
+		void ExpirePendingItems();
 
-	class ItemHoverEvent : public UIEvent
-	{
-	public:
-		ItemHoverEvent(Item::State new_state, Item::State old_state, bool isLeft, Item* item) :
-			new_state(new_state),
-			old_state(old_state),
-			isLeft(isLeft),
-			item(item)
-		{}
-		Item::State new_state;
-		Item::State old_state;
-		bool        isLeft;
-		Item*       item;
-		Type        type() { return Type::ItemHovered; }
-	};
+		/* About 5 seconds at 90 Hz. Items normally arrive within a frame or two */
+		static constexpr uint32_t kPendingItemFrames = 450;
 
-	class CreateExtraDataEvent : public UIEvent
-	{
-	public:
-		CreateExtraDataEvent(RE::InventoryEntryData* entry, int count, RE::NiTransform local) :
-			entry(entry),
-			count(count),
-			local(local)
-		{}
-		RE::InventoryEntryData* entry;
-		int                     count;
-		RE::NiTransform         local;
-		Type                    type() { return Type::CreateExtraDataEvent; }
+		std::unordered_map<uint64_t, NewItemEvent> pending_items;  // keyed by PendingKey
+		helper::IDAllocator                        item_ids;
+		std::unordered_map<RE::FormID, LayoutTable> layouts;  // keyed by wearer
 	};
 
 	inline void AddObjectRefToInventory(
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "nif_index.h"
+
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace backpack
+{
+	/* Bounds of a model in its own space, unscaled */
+	struct ModelBounds
+	{
+		RE::NiPoint3 center;
+		float        radius = 0;
+		RE::NiPoint3 extents;  // half size of the box around the model
+	};
+
+	/** Model bounds remembered across sessions, keyed by model path. Bounds are otherwise only
+	 * known after the model's 3D has been created, this way sizing decisions can be made before.
+	 *
+	 * Each entry stores the timestamp of the loose model file it was measured from, or 0 if the
+	 * model is in an archive. Entries whose timestamp no longer matches are dropped the first
+	 * time they're looked up. Models that were never measured fall back to the index baked
+	 * offline by tools/nif_baker, if there is one, those are never written to the file.
+	 * Main thread only.
+	 */
+	class ModelBoundsCache
+	{
+	public:
+		static constexpr uint32_t kMagic = 0x43504242;  // "BBPC"
+		static constexpr uint32_t kVersion = 1;
+		/* relative to the Data folder, next to the ini */
+		static constexpr const char* kFilePath = "SKSE/Plugins/BackpackVR.bounds";
+		static constexpr const char* kIndexPath = "SKSE/Plugins/BackpackVR.nifindex";
+
+		static ModelBoundsCache* GetSingleton()
+		{
+			static ModelBoundsCache singleton;
+			return &singleton;
+		}
+
+		/* Replaces the cache with the contents of the file and reads the baked index. A missing
+		 * or invalid file leaves it empty */
+		void Load();
+
+		/* Writes the cache to the file if anything was recorded since the last Load or Save */
+		void Save();
+
+		/* Returns: the bounds of a_model, nullptr if they aren't known */
+		const ModelBounds* Find(std::string_view a_model);
+
+		void Record(std::string_view a_model, const ModelBounds& a_bounds);
+
+		/* The index baked by tools/nif_baker, empty if there is none */
+		const nifindex::IndexView& GetIndex() const { return baked; }
+
+	private:
+		ModelBoundsCache() = default;
+		~ModelBoundsCache() = default;
+		ModelBoundsCache(const ModelBoundsCache&) = delete;
+		ModelBoundsCache(ModelBoundsCache&&) = delete;
+		ModelBoundsCache& operator=(const ModelBoundsCache&) = delete;
+		ModelBoundsCache& operator=(ModelBoundsCache&&) = delete;
+
+		/* Returns: last write time of the loose model file, 0 if there is none */
+		static int64_t GetModelTimestamp(std::string_view a_model);
+
+		struct Entry
+		{
+			ModelBounds bounds;
+			int64_t     timestamp = 0;
+			bool        checked = false;  // timestamp was compared against the file this session
+		};
+
+		struct PathHash
+		{
+			using is_transparent = void;
+			std::size_t operator()(std::string_view a_path) const
+			{
+				return std::hash<std::string_view>{}(a_path);
+			}
+		};
+
+		std::unordered_map<std::string, Entry, PathHash, std::equal_to<>> entries;
+		bool                                                              dirty = false;
+
+		// models found in the index, kept apart from entries so they are never saved and a
+		// rebaked index always wins over them
+		std::unordered_map<std::string, ModelBounds, PathHash, std::equal_to<>> baked_bounds;
+		std::vector<std::byte>                                                  baked_data;
+		nifindex::IndexView                                                     baked;
+	};
+}
@@ -0,0 +1,163 @@
+/** Bounding volume hierarchy over spheres. Used by Views to pick Items without testing every one.
+ * Bounds are expected in the View's local space, so the tree stays valid while the backpack moves
+ * and only needs work when items are added, removed or moved inside the View.
+ *
+ * Leaves hold up to 4 spheres packed as structure-of-arrays, so a leaf is tested against both
+ * hands with a handful of SSE instructions.
+ */
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+#include <xmmintrin.h>
+
+namespace bvh
+{
+	struct Sphere
+	{
+		RE::NiPoint3 center;
+		float        radius = 0;
+	};
+
+	/* Up to 4 spheres in structure-of-arrays layout. Unused lanes have a negative radius_sq */
+	struct alignas(16) SphereBlock
+	{
+		static constexpr uint32_t kWidth = 4;
+
+		float    x[kWidth];
+		float    y[kWidth];
+		float    z[kWidth];
+		float    radius_sq[kWidth];
+		uint32_t index[kWidth];
+	};
+
+	/** Returns: bitmask of overlapping lanes, bits 0-3 for a_points[0] and bits 4-7 for
+	 * a_points[1]
+	 *
+	 * Tests both points against all 4 spheres in the block. Squared distances are written to
+	 * a_dist_sq for every lane, overlapping or not.
+	 */
+	inline uint32_t OverlapBlock(const SphereBlock& a_block, const RE::NiPoint3 (&a_points)[2],
+		float (&a_dist_sq)[2][SphereBlock::kWidth])
+	{
+		const __m128 x = _mm_load_ps(a_block.x);
+		const __m128 y = _mm_load_ps(a_block.y);
+		const __m128 z = _mm_load_ps(a_block.z);
+		const __m128 r = _mm_load_ps(a_block.radius_sq);
+
+		uint32_t mask = 0;
+		for (int p = 0; p < 2; p++)
+		{
+			__m128 dx = _mm_sub_ps(x, _mm_set1_ps(a_points[p].x));
+			__m128 dy = _mm_sub_ps(y, _mm_set1_ps(a_points[p].y));
+			__m128 dz = _mm_sub_ps(z, _mm_set1_ps(a_points[p].z));
+			__m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+				_mm_mul_ps(dz, dz));
+			_mm_store_ps(a_dist_sq[p], d);
+			mask |= (uint32_t)_mm_movemask_ps(_mm_cmplt_ps(d, r)) << (p * SphereBlock::kWidth);
+		}
+		return mask;
+	}
+
+	class SphereTree
+	{
+	public:
+		/* Rebuilds the hierarchy from scratch. Sphere indices are the indices passed to the query
+		 * visitor. Spheres with radius <= 0 are left out */
+		void Build(const std::vector<Sphere>& a_spheres);
+
+		/* Recomputes the leaf data and node boxes without changing the topology. Use when
+		 * spheres moved but none were added or removed */
+		void Refit(const std::vector<Sphere>& a_spheres);
+
+		/** Calls a_visitor(point, index, dist_sq) for each sphere that contains one of the points,
+		 * where point is 0 or 1. Both points are handled in the same traversal.
+		 *
+		 * a_point_mask:	bit 0 enables a_points[0], bit 1 enables a_points[1]
+		 */
+		template <typename F>
+		void Query(const RE::NiPoint3 (&a_points)[2], uint32_t a_point_mask, F&& a_visitor) const
+		{
+			if (nodes.empty() || !(a_point_mask & 3)) { return; }
+
+			uint32_t stack[64];
+			int      top = 0;
+			stack[top++] = 0;
+
+			while (top)
+			{
+				auto& node = nodes[stack[--top]];
+				if (!((a_point_mask & 1 && node.Contains(a_points[0])) ||
+						(a_point_mask & 2 && node.Contains(a_points[1]))))
+				{
+					continue;
+				}
+
+				if (node.count)
+				{
+					// lanes of disabled points are dropped
+					uint32_t lanes = (a_point_mask & 1 ? 0x0f : 0) | (a_point_mask & 2 ? 0xf0 : 0);
+					float    dist_sq[2][SphereBlock::kWidth];
+
+					for (auto b = node.first; b < node.first + BlockCount(node.count); b++)
+					{
+						auto& block = blocks[b];
+						for (auto hits = OverlapBlock(block, a_points, dist_sq) & lanes; hits;
+							 hits &= hits - 1)
+						{
+							auto bit = std::countr_zero(hits);
+							auto p = bit / SphereBlock::kWidth;
+							auto lane = bit % SphereBlock::kWidth;
+							a_visitor(p, block.index[lane], dist_sq[p][lane]);
+						}
+					}
+				}
+				else
+				{
+					auto index = (uint32_t)(&node - nodes.data());
+					stack[top++] = node.first;
+					stack[top++] = index + 1;
+				}
+			}
+		}
+
+		void Clear()
+		{
+			nodes.clear();
+			blocks.clear();
+		}
+
+		bool Empty() const { return nodes.empty(); }
+
+	private:
+		struct Node
+		{
+			RE::NiPoint3 min;
+			RE::NiPoint3 max;
+			/* leaf: index of the first of its blocks. interior: index of the right child, the left
+			 * child is always the next node */
+			uint32_t first = 0;
+			/* number of spheres in a leaf, 0 for interior nodes */
+			uint32_t count = 0;
+
+			bool Contains(const RE::NiPoint3& p) const
+			{
+				return p.x >= min.x && p.x <= max.x && p.y >= min.y && p.y <= max.y &&
+					p.z >= min.z && p.z <= max.z;
+			}
+		};
+
+		static uint32_t BlockCount(uint32_t a_spheres)
+		{
+			return (a_spheres + SphereBlock::kWidth - 1) / SphereBlock::kWidth;
+		}
+
+		uint32_t BuildRecursive(const std::vector<Sphere>& a_spheres,
+			std::vector<uint32_t>& a_order, uint32_t a_begin, uint32_t a_end, int a_depth);
+		void     FitLeaf(Node& a_node, const std::vector<Sphere>& a_spheres);
+
+		std::vector<Node>        nodes;
+		std::vector<SphereBlock> blocks;
+	};
+}
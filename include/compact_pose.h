@@ -0,0 +1,128 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+
+namespace helper
+{
+	/* Position and rotation of an Item in its View, 12 bytes instead of the 52 of an NiTransform.
+	 *
+	 * The rotation is a unit quaternion stored as its three smallest components, 15 bits each,
+	 * and the index of the largest one, which is rebuilt from the unit length. The position is
+	 * 16-bit fixed point over [-range, range] per axis, range is picked by the View from its
+	 * extent. Decoding and encoding again gives back the same bits.
+	 */
+	struct CompactPose
+	{
+		using Vector = std::array<float, 3>;
+		using Quaternion = std::array<float, 4>;  // x y z w
+
+		static constexpr int      kComponentBits = 15;
+		static constexpr uint64_t kComponentMask = (1 << kComponentBits) - 1;
+		static constexpr uint64_t kComponentZero = kComponentMask / 2;
+		static constexpr float    kComponentLimit = 0.70710678f;  // 1/sqrt(2)
+		static constexpr float    kPositionMax = 32767.f;
+
+		// w is the largest component, x y z are zero
+		static constexpr uint64_t kIdentity = 3ull << (kComponentBits * 3) |
+			kComponentZero << (kComponentBits * 2) | kComponentZero << kComponentBits |
+			kComponentZero;
+
+		int16_t  position[3] = {};
+		uint16_t rotation[3] = { (uint16_t)(kIdentity >> 32), (uint16_t)(kIdentity >> 16),
+			(uint16_t)kIdentity };
+
+		static CompactPose Encode(
+			const Vector& a_position, const Quaternion& a_rotation, const Vector& a_range)
+		{
+			CompactPose pose;
+			for (int i = 0; i < 3; i++)
+			{
+				auto value = a_range[i] > 0 ? a_position[i] / a_range[i] * kPositionMax : 0.f;
+				pose.position[i] =
+					(int16_t)std::clamp(std::round(value), -kPositionMax, kPositionMax);
+			}
+			pose.SetRotation(a_rotation);
+			return pose;
+		}
+
+		Vector DecodePosition(const Vector& a_range) const
+		{
+			Vector result;
+			for (int i = 0; i < 3; i++) { result[i] = position[i] * (a_range[i] / kPositionMax); }
+			return result;
+		}
+
+		Quaternion DecodeRotation() const
+		{
+			auto bits = GetRotationBits();
+			auto largest = (int)(bits >> (kComponentBits * 3)) & 3;  // the top bit is spare
+
+			Quaternion q;
+			float      sum = 0;
+			float      floor = 0;
+			for (int i = 0, shift = kComponentBits * 2; i < 4; i++)
+			{
+				if (i == largest) { continue; }
+				q[i] = Dequantize((bits >> shift) & kComponentMask);
+				sum += q[i] * q[i];
+				shift -= kComponentBits;
+
+				// When two components are about equally large, rounding can leave the rebuilt one
+				// a hair smaller and the next encode would pick the other. Keep it the largest,
+				// ahead of the lower indices that win ties
+				auto size = std::abs(q[i]);
+				floor = std::max(floor, i < largest ? std::nextafter(size, 1.f) : size);
+			}
+			q[largest] = std::max(std::sqrt(std::max(0.f, 1.f - sum)), floor);
+			return q;
+		}
+
+		bool operator==(const CompactPose&) const = default;
+
+	private:
+		// symmetric around kComponentZero, so 0 and -x encode exactly
+		static uint64_t Quantize(float a_value)
+		{
+			auto unit = std::clamp(a_value, -kComponentLimit, kComponentLimit) / kComponentLimit;
+			return (uint64_t)((int32_t)std::round(unit * kComponentZero) + (int32_t)kComponentZero);
+		}
+
+		static float Dequantize(uint64_t a_value)
+		{
+			return ((float)a_value - kComponentZero) * (kComponentLimit / kComponentZero);
+		}
+
+		uint64_t GetRotationBits() const
+		{
+			return (uint64_t)rotation[0] << 32 | (uint64_t)rotation[1] << 16 | rotation[2];
+		}
+
+		/* a_rotation is expected to be normalized. It is not normalized again here, so decoded
+		 * values encode to the same bits */
+		void SetRotation(const Quaternion& a_rotation)
+		{
+			int largest = 0;
+			for (int i = 1; i < 4; i++)
+			{
+				if (std::abs(a_rotation[i]) > std::abs(a_rotation[largest])) { largest = i; }
+			}
+
+			// q and -q are the same rotation, the largest component is always kept positive
+			auto scale = a_rotation[largest] < 0 ? -1.f : 1.f;
+
+			uint64_t bits = (uint64_t)largest;
+			for (int i = 0; i < 4; i++)
+			{
+				if (i == largest) { continue; }
+				bits = bits << kComponentBits | Quantize(a_rotation[i] * scale);
+			}
+			rotation[0] = (uint16_t)(bits >> 32);
+			rotation[1] = (uint16_t)(bits >> 16);
+			rotation[2] = (uint16_t)bits;
+		}
+	};
+	static_assert(sizeof(CompactPose) == 12);
+}
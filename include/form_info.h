@@ -0,0 +1,48 @@
+#pragma once
+
+#include <unordered_map>
+
+namespace backpack
+{
+	/* What the backpack needs to know about a base form to spawn an Item of it */
+	struct FormInfo
+	{
+		const char* model = nullptr;  // world model path, nullptr if there is none
+		float       bound_radius = 0;  // from the model if it's in the ModelBoundsCache
+		uint32_t    view_mask = 0;  // View::Type bits of the Views that accept the form
+	};
+
+	/* FormInfo resolved once per FormID, so spawning doesn't repeat the model lookup casts and
+	 * the View acceptance checks. Must be cleared when settings that affect acceptance change, and
+	 * on revert: created forms (0xFF) are freed and their FormIDs reused by the next save.
+	 * Main thread only */
+	class FormInfoCache
+	{
+	public:
+		static FormInfoCache* GetSingleton()
+		{
+			static FormInfoCache singleton;
+			return &singleton;
+		}
+
+		const FormInfo& Get(RE::TESBoundObject* a_obj)
+		{
+			if (auto it = infos.find(a_obj->GetFormID()); it != infos.end()) { return it->second; }
+			return infos.emplace(a_obj->GetFormID(), Resolve(a_obj)).first->second;
+		}
+
+		void Clear() { infos.clear(); }
+
+	private:
+		FormInfoCache() = default;
+		~FormInfoCache() = default;
+		FormInfoCache(const FormInfoCache&) = delete;
+		FormInfoCache(FormInfoCache&&) = delete;
+		FormInfoCache& operator=(const FormInfoCache&) = delete;
+		FormInfoCache& operator=(FormInfoCache&&) = delete;
+
+		static FormInfo Resolve(RE::TESBoundObject* a_obj);
+
+		std::unordered_map<RE::FormID, FormInfo> infos;
+	};
+}
@@ -88,4 +88,7 @@ namespace helper
 	const char* GetObjectModelPath(RE::TESBoundObject* a_obj);
 	const char* GetObjectModelPath(RE::TESObjectREFR* a_obj);
 
+	/* Returns: radius of the sphere around the object bounds from the form, 0 if they're unset */
+	float GetBoundRadius(RE::TESBoundObject* a_obj);
+
 }
@@ -1,4 +1,5 @@
 #pragma once
+#include "compact_pose.h"
 #include "helper_game.h"
 
 #include <algorithm>
@@ -44,6 +45,13 @@ namespace helper
 
 	void Quat2Mat(NiMatrix3& matrix, NiQuaternion& quaternion);
 
+	/* Returns: the unit quaternion of a rotation matrix */
+	NiQuaternion Mat2Quat(const NiMatrix3& a_matrix);
+
+	/* a_range is the largest coordinate the pose can hold on each axis. Scale is not kept */
+	CompactPose PackPose(const NiTransform& a_transform, const NiPoint3& a_range);
+	NiTransform UnpackPose(const CompactPose& a_pose, const NiPoint3& a_range);
+
 	void slerpQuat(float interp, NiQuaternion& q1, NiQuaternion& q2, NiMatrix3& out);
 
 }
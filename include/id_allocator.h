@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace helper
+{
+	/* Hands out 16-bit IDs that are unique while they are in use. Each ID carries the generation
+	 * of its slot, so after a slot is released and reused, references to the old ID no longer
+	 * match. All IDs have the top two bits set to stay clear of the small IDs the game assigns.
+	 * Not thread safe */
+	class IDAllocator
+	{
+	public:
+		static constexpr uint16_t kTag = 0xC000;
+		static constexpr int      kSlotBits = 9;
+		static constexpr int      kGenerationBits = 5;
+		static constexpr uint32_t kSlots = 1 << kSlotBits;
+
+		IDAllocator() { Clear(); }
+
+		/* Returns: a new ID, or 0 if every slot is in use */
+		uint16_t Allocate()
+		{
+			if (!free_count) { return 0; }
+
+			auto slot = free_slots[--free_count];
+			live[slot] = true;
+			return (uint16_t)(kTag | generation[slot] << kSlotBits | slot);
+		}
+
+		/* Frees the ID's slot for reuse. IDs that aren't live are ignored */
+		void Release(uint16_t a_id)
+		{
+			if (!IsLive(a_id)) { return; }
+
+			auto slot = a_id & (kSlots - 1);
+			live[slot] = false;
+			generation[slot] = (generation[slot] + 1) & ((1 << kGenerationBits) - 1);
+			free_slots[free_count++] = (uint16_t)slot;
+		}
+
+		/* Returns: true if a_id is in the range this allocator hands out */
+		static bool Owns(uint16_t a_id) { return (a_id & kTag) == kTag; }
+
+		bool IsLive(uint16_t a_id) const
+		{
+			auto slot = a_id & (kSlots - 1);
+			return Owns(a_id) && live[slot] &&
+				generation[slot] == ((a_id & ~kTag) >> kSlotBits);
+		}
+
+		uint32_t InUse() const { return kSlots - free_count; }
+
+		/* Releases every ID. Generations are kept, so IDs from before stay stale */
+		void Clear()
+		{
+			for (uint32_t i = 0; i < kSlots; i++)
+			{
+				if (live[i])
+				{
+					live[i] = false;
+					generation[i] = (generation[i] + 1) & ((1 << kGenerationBits) - 1);
+				}
+				// lowest slots are handed out first
+				free_slots[i] = (uint16_t)(kSlots - 1 - i);
+			}
+			free_count = kSlots;
+		}
+
+	private:
+		static_assert(kSlotBits + kGenerationBits == 14, "IDs must fit below the tag bits");
+
+		std::array<uint8_t, kSlots>  generation = {};
+		std::array<bool, kSlots>     live = {};
+		std::array<uint16_t, kSlots> free_slots = {};
+		uint32_t                     free_count = 0;
+	};
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <unordered_map>
+
+namespace backpack
+{
+	/* Mirror of an actor's inventory, keyed by base object. Seeded once with GetInventory() and
+	 * then kept up to date from container change deltas, so looking up one object doesn't build
+	 * a copy of the whole inventory. Extra data lists are read from the live InventoryChanges
+	 * entry */
+	class InventoryMirror
+	{
+	public:
+		struct Entry
+		{
+			int count = 0;
+			/* The entry in the owner's InventoryChanges. nullptr if the items only come from the
+			 * base container and have never been changed. Looked up again on every change of
+			 * the object, since the game frees entries that net back to zero */
+			RE::InventoryEntryData* changes = nullptr;
+
+			RE::BSSimpleList<RE::ExtraDataList*>* GetExtraLists() const
+			{
+				return changes ? changes->extraLists : nullptr;
+			}
+		};
+
+		void Seed(RE::TESObjectREFR* a_owner);
+
+		void Clear()
+		{
+			entries.clear();
+			seeded = false;
+		}
+
+		bool IsSeeded() const { return seeded; }
+
+		/* Applies a container change. a_delta is positive for items added to the owner */
+		void Apply(RE::TESObjectREFR* a_owner, RE::TESBoundObject* a_obj, int a_delta);
+
+		const Entry* Find(RE::TESBoundObject* a_obj) const
+		{
+			auto it = entries.find(a_obj);
+			return it != entries.end() ? &it->second : nullptr;
+		}
+
+		const std::unordered_map<RE::TESBoundObject*, Entry>& GetEntries() const
+		{
+			return entries;
+		}
+
+		/* Compares the mirror against the game's inventory and logs every difference.
+		 * Returns: true if they match */
+		bool DebugCheck(RE::TESObjectREFR* a_owner) const;
+
+	private:
+		static RE::InventoryEntryData* FindChanges(
+			RE::TESObjectREFR* a_owner, RE::TESBoundObject* a_obj);
+
+		std::unordered_map<RE::TESBoundObject*, Entry> entries;
+		bool                                           seeded = false;
+	};
+}
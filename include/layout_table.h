@@ -0,0 +1,76 @@
+#pragma once
+
+#include "compact_pose.h"
+#include "id_allocator.h"
+
+#include <optional>
+#include <unordered_map>
+
+namespace backpack
+{
+	/** Where each placed item stack of one wearer sits in its View, saved in the SKSE co-save.
+	 * A stack is identified by its base form and its ExtraUniqueID. Stacks that don't have one
+	 * yet, or only carry a transient ID from the Controller's IDAllocator, get a layout key
+	 * stamped on them, which also keeps the game from merging them with other stacks of the
+	 * same form. IDs the game assigned are used as they are, never rewritten.
+	 *
+	 * Layout keys have the top bits 10, clear of the game's own IDs and of the IDAllocator's.
+	 * Main thread only.
+	 */
+	class LayoutTable
+	{
+	public:
+		static constexpr uint16_t kKeyTag = 0x8000;
+		static constexpr uint16_t kKeyMask = 0x3FFF;
+
+		/* Bytes per entry in the co-save: base form, key, then the pose's position and rotation
+		 * words. Written field by field, so there is no padding */
+		static constexpr uint32_t kEntrySize = 4 + 2 + 6 * 2;
+
+		static bool IsKey(uint16_t a_id) { return (a_id & ~kKeyMask) == kKeyTag; }
+
+		/* Returns: the stored pose of the stack, nullopt if it has none */
+		std::optional<helper::CompactPose> Find(
+			const RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra) const;
+
+		/* Stores a_pose for the stack, stamping a new key on it if it doesn't have one */
+		void Record(const RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra,
+			const helper::CompactPose& a_pose);
+
+		/* Drops the entries whose stack is no longer in a_wearer's inventory */
+		void Prune(RE::TESObjectREFR* a_wearer);
+
+		void Clear()
+		{
+			entries.clear();
+			next_key = 0;
+		}
+
+		/* Writes the table as one record, tagged with the wearer */
+		bool Save(SKSE::SerializationInterface* a_intfc, RE::FormID a_wearer) const;
+
+		/* Reads the wearer at the start of the current record.
+		 * Returns: the resolved wearer, 0 on failure */
+		static RE::FormID ReadWearer(SKSE::SerializationInterface* a_intfc);
+
+		/* Reads the rest of the current record, a_length bytes after the wearer. Records that
+		 * claim more entries than fit in a_length are rejected */
+		bool Load(SKSE::SerializationInterface* a_intfc, uint32_t a_length);
+
+		std::size_t Size() const { return entries.size(); }
+
+	private:
+		static uint64_t MakeKey(RE::FormID a_base, uint16_t a_key)
+		{
+			return (uint64_t)a_base << 16 | a_key;
+		}
+
+		/* Returns: the ID the stack is stored under, 0 if it has none or only a transient one */
+		static uint16_t GetStackKey(RE::ExtraDataList* a_extra);
+
+		uint16_t NewKey();
+
+		std::unordered_map<uint64_t, helper::CompactPose> entries;
+		uint16_t                                          next_key = 0;
+	};
+}
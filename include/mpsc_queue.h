@@ -0,0 +1,70 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+namespace helper
+{
+	/* Unbounded multi-producer, single-consumer queue. Push is lock-free and can be called from
+	 * any thread. Drain takes everything pushed so far in one atomic exchange and must only be
+	 * called from the consuming thread. Elements are drained in push order */
+	template <typename T>
+	class MPSCQueue
+	{
+	public:
+		MPSCQueue() = default;
+		MPSCQueue(const MPSCQueue&) = delete;
+		MPSCQueue& operator=(const MPSCQueue&) = delete;
+
+		~MPSCQueue() { Drain([](T&&) {}); }
+
+		void Push(T a_item)
+		{
+			auto node = new Node{ std::move(a_item), head.load(std::memory_order_relaxed) };
+			while (!head.compare_exchange_weak(
+				node->next, node, std::memory_order_release, std::memory_order_relaxed))
+			{}
+		}
+
+		/* Calls a_consumer(T&&) for every element pushed before the call.
+		 * Returns: number of elements drained */
+		template <typename F>
+		std::size_t Drain(F&& a_consumer)
+		{
+			auto list = head.exchange(nullptr, std::memory_order_acquire);
+
+			// the list is newest first, reverse it to get push order
+			Node* ordered = nullptr;
+			while (list)
+			{
+				auto next = list->next;
+				list->next = ordered;
+				ordered = list;
+				list = next;
+			}
+
+			std::size_t count = 0;
+			while (ordered)
+			{
+				auto next = ordered->next;
+				a_consumer(std::move(ordered->item));
+				delete ordered;
+				ordered = next;
+				count++;
+			}
+			return count;
+		}
+
+		bool Empty() const { return !head.load(std::memory_order_relaxed); }
+
+	private:
+		struct Node
+		{
+			T     item;
+			Node* next;
+		};
+
+		std::atomic<Node*> head = nullptr;
+	};
+}
@@ -0,0 +1,151 @@
+/** On-disk format of the NIF index written by tools/nif_baker. Shared by the tool and the
+ * plugin, so this header only uses the standard library.
+ *
+ * The file is used in place: a Header, then ModelRecords sorted by path hash, then ViewRecords,
+ * then a string table of null terminated strings. All offsets are relative to the start of the
+ * file and every section is 8 byte aligned, so a read or mapped file needs no further parsing.
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace nifindex
+{
+	constexpr uint32_t kMagic = 0x5846494E;  // "NIFX"
+	constexpr uint32_t kVersion = 1;
+
+	struct Header
+	{
+		uint32_t magic = kMagic;
+		uint32_t version = kVersion;
+		uint32_t model_count = 0;
+		uint32_t models_offset = 0;
+		uint32_t view_count = 0;
+		uint32_t views_offset = 0;
+		uint32_t strings_offset = 0;
+		uint32_t strings_size = 0;
+	};
+
+	/* Bounds of the whole model in its root node's space */
+	struct ModelRecord
+	{
+		uint64_t path_hash = 0;
+		uint32_t path = 0;  // string offset, normalized path relative to meshes
+		uint32_t first_view = 0;
+		uint32_t view_count = 0;
+		float    center[3] = {};
+		float    radius = 0;
+		float    extents[3] = {};  // half size of the box around the model
+	};
+
+	/* A View node, i.e. a direct child of the model root with a View name */
+	struct ViewRecord
+	{
+		uint32_t name = 0;  // string offset
+		float    translate[3] = {};
+		float    extent[3] = {};  // the node's "extent" NiVectorExtraData, 0 if it has none
+	};
+
+	static_assert(sizeof(Header) % 4 == 0 && sizeof(ModelRecord) % 8 == 0 &&
+				  sizeof(ViewRecord) % 4 == 0);
+
+	/* Lower case, backslash separated and without a leading "meshes\", as the index keys are */
+	inline std::string NormalizePath(std::string_view a_path)
+	{
+		std::string path(a_path);
+		std::transform(path.begin(), path.end(), path.begin(), [](char c) {
+			if (c == '/') { return '\\'; }
+			return (c >= 'A' && c <= 'Z') ? (char)(c - 'A' + 'a') : c;
+		});
+		if (path.starts_with("meshes\\")) { path.erase(0, 7); }
+		return path;
+	}
+
+	/* FNV-1a of the normalized path */
+	inline uint64_t HashPath(std::string_view a_normalized)
+	{
+		uint64_t hash = 0xcbf29ce484222325;
+		for (auto c : a_normalized)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 0x100000001b3;
+		}
+		return hash;
+	}
+
+	/* Read only view over an index in memory */
+	class IndexView
+	{
+	public:
+		/* Returns: false if a_data isn't a valid index, the view is left empty then */
+		bool Attach(std::span<const std::byte> a_data)
+		{
+			*this = {};
+			if (a_data.size() < sizeof(Header)) { return false; }
+
+			auto header = reinterpret_cast<const Header*>(a_data.data());
+			if (header->magic != kMagic || header->version != kVersion) { return false; }
+
+			auto fits = [&](uint64_t a_offset, uint64_t a_count, std::size_t a_size) {
+				return a_offset % alignof(ModelRecord) == 0 &&
+					a_offset + a_count * a_size <= a_data.size();
+			};
+			if (!fits(header->models_offset, header->model_count, sizeof(ModelRecord)) ||
+				!fits(header->views_offset, header->view_count, sizeof(ViewRecord)) ||
+				!fits(header->strings_offset, header->strings_size, 1))
+			{
+				return false;
+			}
+
+			models = { reinterpret_cast<const ModelRecord*>(a_data.data() + header->models_offset),
+				header->model_count };
+			views = { reinterpret_cast<const ViewRecord*>(a_data.data() + header->views_offset),
+				header->view_count };
+			strings = { reinterpret_cast<const char*>(a_data.data() + header->strings_offset),
+				header->strings_size };
+			return true;
+		}
+
+		bool Empty() const { return models.empty(); }
+
+		/* Returns: the record for the model path, nullptr if it isn't in the index */
+		const ModelRecord* Find(std::string_view a_path) const
+		{
+			auto normalized = NormalizePath(a_path);
+			auto hash = HashPath(normalized);
+			auto it = std::lower_bound(models.begin(), models.end(), hash,
+				[](const ModelRecord& a, uint64_t b) { return a.path_hash < b; });
+
+			for (; it != models.end() && it->path_hash == hash; ++it)
+			{
+				if (GetString(it->path) == normalized) { return &*it; }
+			}
+			return nullptr;
+		}
+
+		std::span<const ViewRecord> GetViews(const ModelRecord& a_model) const
+		{
+			if (a_model.first_view + (uint64_t)a_model.view_count > views.size()) { return {}; }
+			return views.subspan(a_model.first_view, a_model.view_count);
+		}
+
+		std::string_view GetString(uint32_t a_offset) const
+		{
+			if (a_offset >= strings.size()) { return {}; }
+			auto str = strings.substr(a_offset);
+			return str.substr(0, str.find('\0'));
+		}
+
+		std::span<const ModelRecord> GetModels() const { return models; }
+
+	private:
+		std::span<const ModelRecord> models;
+		std::span<const ViewRecord>  views;
+		std::string_view             strings;
+	};
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "bvh.h"
+
+#include <optional>
+#include <vector>
+
+namespace helper
+{
+	/** Coarse voxel grid over a box, counting how many spheres overlap each cell. Cells are cubes
+	 * sized so the longest side of the box has kMaxCells of them.
+	 *
+	 * Free space is answered from a distance field: the clearance of every cell, i.e. how far its
+	 * center is from the nearest occupied cell or wall. It is rebuilt with a two-pass chamfer
+	 * transform the next time it's needed after the occupancy changed.
+	 */
+	class OccupancyGrid
+	{
+	public:
+		static constexpr int kMaxCells = 16;
+
+		/* Sets the box and clears all occupancy */
+		void Reset(const RE::NiPoint3& a_min, const RE::NiPoint3& a_max);
+
+		void Add(const bvh::Sphere& a_sphere) { Stamp(a_sphere, 1); }
+		void Remove(const bvh::Sphere& a_sphere) { Stamp(a_sphere, -1); }
+
+		/** Returns: the center of the cell closest to a_anchor that has at least a_radius of
+		 * clearance, nullopt if there is no such cell */
+		std::optional<RE::NiPoint3> FindFree(const RE::NiPoint3& a_anchor, float a_radius);
+
+	private:
+		void Stamp(const bvh::Sphere& a_sphere, int a_delta);
+
+		void UpdateClearance();
+
+		int Index(int x, int y, int z) const { return (z * dims[1] + y) * dims[0] + x; }
+
+		RE::NiPoint3 CellCenter(int x, int y, int z) const
+		{
+			return origin + RE::NiPoint3(x + 0.5f, y + 0.5f, z + 0.5f) * cell;
+		}
+
+		RE::NiPoint3          origin;
+		float                 cell = 1;
+		int                   dims[3] = {};
+		std::vector<uint16_t> occupancy;
+		std::vector<float>    clearance;
+		bool                  dirty = true;
+	};
+}
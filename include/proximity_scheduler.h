@@ -0,0 +1,88 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+
+namespace helper
+{
+	/* Sorts a backpack into near/mid/far from its squared distance to the player, and decides
+	 * when that needs checking again. Near is left only past interact_exit, so hovering at the edge
+	 * doesn't flip the state every frame. A mid backpack is checked again once the player could
+	 * have crossed into another zone, later the farther it is from the edges.
+	 *
+	 * Works on squared distances only: the margin to each edge is bounded from below by dividing
+	 * the difference of squares by the largest possible sum of the two distances.
+	 */
+	class ProximityScheduler
+	{
+	public:
+		enum class Zone : uint8_t
+		{
+			kNear,
+			kMid,
+			kFar
+		};
+
+		/* Radii, not squared. interact_exit >= interact */
+		struct Bands
+		{
+			float interact = 0;       // entering near
+			float interact_exit = 0;  // leaving near
+			float shutoff = 0;        // entering far
+		};
+
+		/* How far the player and the backpack can close in on each other in one frame, running
+		 * or on horseback at low framerates */
+		static constexpr float    kMaxApproach = 16.f;
+		static constexpr uint32_t kMaxInterval = 45;
+
+		/* Returns: true if the distance has to be checked on a_frame */
+		bool Due(uint32_t a_frame) const
+		{
+			return stale || (int32_t)(a_frame - next_frame) >= 0;
+		}
+
+		/* Classifies the distance and schedules the next check */
+		Zone Update(float a_distance_sq, const Bands& a_bands, uint32_t a_frame)
+		{
+			auto near_sq = a_bands.interact * a_bands.interact;
+			auto exit_sq = std::max(a_bands.interact_exit, a_bands.interact);
+			exit_sq *= exit_sq;
+			auto far_sq = a_bands.shutoff * a_bands.shutoff;
+
+			if (a_distance_sq < (zone == Zone::kNear ? exit_sq : near_sq)) { zone = Zone::kNear; }
+			else if (a_distance_sq < far_sq) { zone = Zone::kMid; }
+			else { zone = Zone::kFar; }
+
+			uint32_t interval = 1;
+			if (zone == Zone::kMid)
+			{
+				// d - r = (d^2 - r^2) / (d + r), and d < shutoff here
+				auto to_near = (a_distance_sq - near_sq) / (a_bands.shutoff + a_bands.interact);
+				auto to_far = (far_sq - a_distance_sq) / (2 * a_bands.shutoff);
+				auto frames = std::min(to_near, to_far) / kMaxApproach;
+				interval = (uint32_t)std::clamp(frames, 1.f, (float)kMaxInterval);
+			}
+			else if (zone == Zone::kFar) { interval = kMaxInterval; }
+
+			next_frame = a_frame + interval;
+			stale = false;
+			return zone;
+		}
+
+		/* Sets the zone the backpack is in now and forces a check on the next frame, e.g. after
+		 * the state was changed from outside. The hysteresis then starts from a_zone */
+		void Reset(Zone a_zone)
+		{
+			zone = a_zone;
+			stale = true;
+		}
+
+		Zone GetZone() const { return zone; }
+
+	private:
+		Zone     zone = Zone::kMid;
+		uint32_t next_frame = 0;
+		bool     stale = true;
+	};
+}
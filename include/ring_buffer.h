@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+
+namespace helper
+{
+	/* Fixed-capacity FIFO that never allocates. Pushing to a full buffer drops the new element and
+	 * counts it as an overflow. Not thread safe */
+	template <typename T, std::size_t N>
+	class RingBuffer
+	{
+		static_assert(std::has_single_bit(N), "RingBuffer capacity must be a power of 2");
+
+	public:
+		/* Returns: false if the buffer was full and a_item was dropped */
+		bool Push(const T& a_item)
+		{
+			if (Size() == N)
+			{
+				overflows++;
+				return false;
+			}
+			buffer[tail++ & (N - 1)] = a_item;
+			return true;
+		}
+
+		/* Returns: false if the buffer was empty */
+		bool Pop(T& a_out)
+		{
+			if (Empty()) { return false; }
+			a_out = std::move(buffer[head++ & (N - 1)]);
+			return true;
+		}
+
+		void Clear() { head = tail = 0; }
+
+		std::size_t Size() const { return tail - head; }
+		bool        Empty() const { return head == tail; }
+
+		static constexpr std::size_t Capacity() { return N; }
+
+		/* Number of elements dropped since the buffer was created */
+		std::size_t Overflows() const { return overflows; }
+
+	private:
+		std::array<T, N> buffer = {};
+		std::size_t      head = 0;
+		std::size_t      tail = 0;
+		std::size_t      overflows = 0;
+	};
+}
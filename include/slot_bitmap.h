@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+
+namespace helper
+{
+	/* Two-level bitmap of occupied slots. The summary words have one bit per leaf word, so the
+	 * lowest free slot and the highest used slot are found with two bit scans instead of a walk
+	 * over every slot. Not thread safe */
+	class SlotBitmap
+	{
+	public:
+		static constexpr uint32_t kWordBits = 64;
+		static constexpr uint32_t kSlots = kWordBits * kWordBits;
+		static constexpr uint32_t kNone = UINT32_MAX;
+
+		/* Returns: the lowest free slot, kNone if every slot is used */
+		uint32_t FirstFree() const
+		{
+			if (!~full) { return kNone; }
+
+			auto word = (uint32_t)std::countr_one(full);
+			return word * kWordBits + std::countr_one(leaves[word]);
+		}
+
+		/* Returns: the highest used slot, kNone if every slot is free */
+		uint32_t LastUsed() const
+		{
+			if (!used) { return kNone; }
+
+			auto word = kWordBits - 1 - std::countl_zero(used);
+			return word * kWordBits + kWordBits - 1 - std::countl_zero(leaves[word]);
+		}
+
+		/* Marks the lowest free slot as used.
+		 * Returns: the slot, kNone if every slot is used */
+		uint32_t Acquire()
+		{
+			auto slot = FirstFree();
+			if (slot != kNone) { Set(slot); }
+			return slot;
+		}
+
+		void Set(uint32_t a_slot)
+		{
+			auto word = a_slot / kWordBits;
+			leaves[word] |= 1ull << (a_slot % kWordBits);
+			used |= 1ull << word;
+			if (!~leaves[word]) { full |= 1ull << word; }
+		}
+
+		void Release(uint32_t a_slot)
+		{
+			auto word = a_slot / kWordBits;
+			leaves[word] &= ~(1ull << (a_slot % kWordBits));
+			full &= ~(1ull << word);
+			if (!leaves[word]) { used &= ~(1ull << word); }
+		}
+
+		bool IsUsed(uint32_t a_slot) const
+		{
+			return a_slot < kSlots && leaves[a_slot / kWordBits] & 1ull << (a_slot % kWordBits);
+		}
+
+		void Clear()
+		{
+			leaves = {};
+			full = 0;
+			used = 0;
+		}
+
+	private:
+		std::array<uint64_t, kWordBits> leaves = {};
+		uint64_t                        full = 0;  // bit set if the leaf word has no free slot
+		uint64_t                        used = 0;  // bit set if the leaf word has a used slot
+	};
+}
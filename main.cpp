@@ -24,6 +24,12 @@ SKSEPluginLoad(const SKSE::LoadInterface* skse)
 
 	SKSE::GetMessagingInterface()->RegisterListener(MessageListener);
 
+	auto serialization = SKSE::GetSerializationInterface();
+	serialization->SetUniqueID(backpack::Controller::kSerializationID);
+	serialization->SetSaveCallback(backpack::Controller::OnGameSaved);
+	serialization->SetLoadCallback(backpack::Controller::OnGameLoaded);
+	serialization->SetRevertCallback(backpack::Controller::OnRevert);
+
 	g_pluginHandle = skse->GetPluginHandle();
 	g_messaging = (SKSE::detail::SKSEMessagingInterface*)skse->QueryInterface(
 		SKSE::LoadInterface::kMessaging);
@@ -16,13 +16,35 @@ namespace art_addon
 		NiAVObject* a_attach_node, NiTransform& a_local, std::function<void(ArtAddon*)> a_callback)
 	{
 		auto manager = ArtAddonManager::GetSingleton();
-		auto art_object = manager->GetArtForm(a_model_path);
+
+		// Once a model has been loaded it can be cloned right here, skipping the effect round trip
+		if (auto master = a_model_path ? manager->GetMaster(a_model_path) : nullptr)
+		{
+			if (a_attach_node && a_target && a_target->IsHandleValid())
+			{
+				auto new_obj = std::shared_ptr<ArtAddon>(new ArtAddon);
+				new_obj->root3D = master->Clone();
+				new_obj->attach_node = a_attach_node;
+				new_obj->target = a_target;
+
+				new_obj->root3D->local = a_local;
+				a_attach_node->AsNode()->AttachChild(new_obj->root3D);
+				if (a_callback) { a_callback(new_obj.get()); }
+
+				NiUpdateData ctx;
+				new_obj->root3D->Update(ctx);
+				return new_obj;
+			}
+		}
+
+		auto art_object = a_model_path ? manager->GetArtForm(a_model_path) : nullptr;
 		int  id = manager->GetNextId();
 
 		/** Using the duration parameter of the BSTempEffect as an ID because anything < 0 has the
-		 * same effect. */
+		 * same effect. ApplyArtObject isn't thread safe, off the main thread it's left to Update */
+		bool on_main_thread = manager->IsMainThread();
 		if (art_object && a_attach_node && a_target && a_target->IsHandleValid() &&
-			a_target->ApplyArtObject(art_object, (float)id))
+			(!on_main_thread || a_target->ApplyArtObject(art_object, (float)id)))
 		{
 			auto new_obj = std::shared_ptr<ArtAddon>(new ArtAddon);
 			new_obj->art_object = art_object;
@@ -31,7 +53,7 @@ namespace art_addon
 			new_obj->target = a_target;
 			if (a_callback) { new_obj->callback = a_callback; }
 
-			manager->new_objects.emplace(id, new_obj);
+			manager->requests.Push({ id, art_object, new_obj, on_main_thread });
 			return new_obj;
 		}
 		else
@@ -41,6 +63,63 @@ namespace art_addon
 		}
 	}
 
+	std::shared_ptr<ArtAddon> ArtAddon::MakePooled(const char* a_model_path,
+		TESObjectREFR* a_target, NiAVObject* a_attach_node, NiTransform& a_local,
+		std::function<void(ArtAddon*)> a_callback)
+	{
+		if (a_attach_node && a_target && a_target->IsHandleValid())
+		{
+			if (auto node = ArtAddonPool::GetSingleton()->Acquire(a_model_path))
+			{
+				auto new_obj = std::shared_ptr<ArtAddon>(new ArtAddon);
+				new_obj->root3D = node.get();
+				new_obj->attach_node = a_attach_node;
+				new_obj->target = a_target;
+				new_obj->pool_model = a_model_path;
+
+				node->local = a_local;
+				a_attach_node->AsNode()->AttachChild(node.get());
+				if (a_callback) { a_callback(new_obj.get()); }
+
+				NiUpdateData ctx;
+				node->Update(ctx);
+				return new_obj;
+			}
+		}
+
+		auto new_obj = Make(a_model_path, a_target, a_attach_node, a_local, a_callback);
+		if (new_obj) { new_obj->pool_model = a_model_path; }
+		return new_obj;
+	}
+
+	ArtAddon::~ArtAddon()
+	{
+		if (root3D && target && target->Is3DLoaded() && root3D->parent)
+		{
+			// keep the node alive through the detach if it goes back to the pool
+			NiPointer<NiAVObject> node(root3D);
+			root3D->parent->DetachChild(root3D);
+			if (pool_model) { ArtAddonPool::GetSingleton()->Release(pool_model, std::move(node)); }
+		}
+	}
+
+	NiPointer<NiAVObject> ArtAddonPool::Acquire(const char* a_model_path)
+	{
+		auto it = free_nodes.find(std::string_view(a_model_path));
+		if (it == free_nodes.end() || it->second.empty()) { return nullptr; }
+
+		auto node = std::move(it->second.back());
+		it->second.pop_back();
+		return node;
+	}
+
+	void ArtAddonPool::Release(const char* a_model_path, NiPointer<NiAVObject> a_node)
+	{
+		auto it = free_nodes.find(std::string_view(a_model_path));
+		if (it == free_nodes.end()) { it = free_nodes.try_emplace(a_model_path).first; }
+		if (it->second.size() < kMaxSparePerModel) { it->second.push_back(std::move(a_node)); }
+	}
+
 	void RemoveCollisionNodes(NiAVObject* a_node)
 	{
 		if (a_node != nullptr)
@@ -62,81 +141,201 @@ namespace art_addon
 	 *  using the ProcessList. */
 	void ArtAddonManager::Update()
 	{
+		stats = {};
+		frame.fetch_add(1, std::memory_order_relaxed);
+		main_thread.store(std::this_thread::get_id(), std::memory_order_relaxed);
+		requests.Drain([this](CreateRequest&& a_request) {
+			if (!a_request.applied)
+			{
+				auto addon = a_request.addon.lock();
+				if (!addon) { return; }  // deleted before the effect was applied
+				if (!addon->target->IsHandleValid() ||
+					!addon->target->ApplyArtObject(a_request.art_object, (float)a_request.id))
+				{
+					SKSE::log::error("Art addon failed: invalid target");
+					return;
+				}
+			}
+			own_artobjects.insert(a_request.art_object);
+			new_objects.emplace(a_request.id, PendingAddon{ std::move(a_request.addon) });
+		});
+
 		if (!new_objects.empty())
 		{
-			std::scoped_lock lock(objects_lock);
+			stats.pending = (uint32_t)new_objects.size();
+
 			if (const auto processLists = ProcessLists::GetSingleton())
 			{
-				processLists->ForEachModelEffect([this](ModelReferenceEffect& a_modelEffect) {
-					if (a_modelEffect.Get3D() && a_modelEffect.lifetime < -1.0f)
+				auto unresolved = new_objects.size();
+				processLists->ForEachModelEffect([&](ModelReferenceEffect& a_modelEffect) {
+					stats.effects_scanned++;
+
+					// the id is not unique to this mod but the ArtObject is
+					if (a_modelEffect.lifetime >= -1.0f || !a_modelEffect.Get3D() ||
+						!own_artobjects.contains(a_modelEffect.artObject))
 					{
-						int id = a_modelEffect.lifetime;
-						if (new_objects.contains(id))
+						return BSContainer::ForEachResult::kContinue;
+					}
+
+					int  id = a_modelEffect.lifetime;
+					auto it = new_objects.find(id);
+					if (it == new_objects.end())
+					{
+						// left over from an attempt that was retried. Other unknown IDs may
+						// belong to a request that was pushed after the drain
+						if (superseded_ids.erase(id))
 						{
-							if (auto addon = new_objects[id].lock())
-							{
-								// the id is not unique to this mod but the ArtObject is
-								if (addon->art_object == a_modelEffect.artObject)
-								{
-									addon->root3D = a_modelEffect.Get3D()->Clone();
-									addon->attach_node->AsNode()->AttachChild(addon->root3D);
-									a_modelEffect.lifetime = 0;
-									addon->root3D->local = std::move(addon->local);
-
-									// .nifs with collision will not be drawn when they're attached to an actor
-									RemoveCollisionNodes(addon->root3D);
-
-									if (addon->callback) { addon->callback(addon.get()); }
-
-									NiUpdateData ctx;
-									a_modelEffect.target.get()->GetCurrent3D()->Update(ctx);
-								}
-							}
-							else
-							{  // check if it's one of our ArtObjects
-								auto it = std::find_if(artobject_cache.begin(),
-									artobject_cache.end(), [&a_modelEffect](const auto& pair) {
-										return pair.second == a_modelEffect.artObject;
-									});
-								if (it != artobject_cache.end())
-								{  // the artAddon was deleted before initialization finished
-									a_modelEffect.lifetime = 0;
-									SKSE::log::trace("deleting MRE {} (orphaned)", id);
-								}
-							}
-							// finished with this ArtAddon, no longer need to track it
-							new_objects.erase(id);
+							a_modelEffect.lifetime = 0;
+							SKSE::log::trace("deleting MRE {} (superseded)", id);
 						}
+						return BSContainer::ForEachResult::kContinue;
 					}
-					return BSContainer::ForEachResult::kContinue;
+
+					if (auto addon = it->second.addon.lock())
+					{
+						addon->root3D = a_modelEffect.Get3D()->Clone();
+						addon->attach_node->AsNode()->AttachChild(addon->root3D);
+						a_modelEffect.lifetime = 0;
+						addon->root3D->local = std::move(addon->local);
+
+						// .nifs with collision will not be drawn when they're attached to an actor
+						RemoveCollisionNodes(addon->root3D);
+
+						if (addon->callback) { addon->callback(addon.get()); }
+
+						// keep a detached copy to clone from next time
+						auto path = a_modelEffect.artObject->GetModel();
+						if (path && masters.size() < kMaxArtForms && !masters.contains(path))
+						{
+							NiPointer<NiAVObject> master(a_modelEffect.Get3D()->Clone());
+							RemoveCollisionNodes(master.get());
+							masters.emplace(path, std::move(master));
+						}
+
+						NiUpdateData ctx;
+						a_modelEffect.target.get()->GetCurrent3D()->Update(ctx);
+					}
+					else
+					{  // the artAddon was deleted before initialization finished
+						a_modelEffect.lifetime = 0;
+						SKSE::log::trace("deleting MRE {} (orphaned)", id);
+					}
+
+					// finished with this ArtAddon, no longer need to track it
+					new_objects.erase(it);
+					stats.resolved++;
+
+					return --unresolved ? BSContainer::ForEachResult::kContinue :
+										  BSContainer::ForEachResult::kStop;
 				});
 			}
+			AgePending();
 		}
 	}
 
-	BGSArtObject* ArtAddonManager::GetArtForm(const char* a_model_path)
+	void ArtAddonManager::AgePending()
 	{
-		if (!artobject_cache.contains(a_model_path))
+		std::vector<std::pair<int, PendingAddon>> retries;
+		for (auto it = new_objects.begin(); it != new_objects.end();)
 		{
-			if (base_artobject)
+			auto& pending = it->second;
+			if (++pending.frames_waiting < kRetryFrames)
 			{
-				if (auto dupe = base_artobject->CreateDuplicateForm(false, nullptr))
+				++it;
+				continue;
+			}
+
+			auto addon = pending.addon.lock();
+			if (addon && pending.retries < kMaxRetries && addon->target &&
+				addon->target->IsHandleValid())
+			{
+				// a new ID, so the old effect is recognized as superseded if it ever shows up
+				int id = GetNextId();
+				if (addon->target->ApplyArtObject(addon->art_object, (float)id))
 				{
-					auto temp = dupe->As<BGSArtObject>();
-					temp->SetModel(a_model_path);
-					artobject_cache[a_model_path] = temp;
-					return temp;
+					SKSE::log::trace("retrying MRE {} as {}", it->first, id);
+					retries.emplace_back(id, PendingAddon{ addon, 0, pending.retries + 1 });
+					superseded_ids.insert(it->first);
+					it = new_objects.erase(it);
+					stats.retried++;
+					continue;
 				}
-				else { SKSE::log::error("error creating form for: {}", a_model_path); }
 			}
-			else { SKSE::log::error("base ArtObject not found"); }
 
-			return nullptr;
+			if (addon) { SKSE::log::error("Art addon failed: model was never created"); }
+			it = new_objects.erase(it);
+			stats.dropped++;
 		}
-		else { return artobject_cache[a_model_path]; }
+		new_objects.insert(retries.begin(), retries.end());
+	}
+
+	BGSArtObject* ArtAddonManager::GetArtForm(std::string_view a_model_path)
+	{
+		std::scoped_lock lock(cache_lock);
+		auto             now = frame.load(std::memory_order_relaxed);
+
+		if (auto it = artobject_cache.find(a_model_path); it != artobject_cache.end())
+		{
+			it->second.last_used = now;
+			artobject_lru.splice(artobject_lru.begin(), artobject_lru, it->second.lru);
+			return it->second.form;
+		}
+
+		if (artobject_cache.size() >= kMaxArtForms && !artobject_lru.empty())
+		{
+			auto victim = artobject_cache.find(*artobject_lru.back());
+			if (now - victim->second.last_used >= kRecycleFrames)
+			{
+				// re-key the node in place, so the key pointer in artobject_lru stays valid
+				auto node = artobject_cache.extract(victim);
+				SKSE::log::trace("recycling art form of {} for {}", node.key(), a_model_path);
+
+				node.key() = a_model_path;
+				node.mapped().form->SetModel(node.key().c_str());
+				node.mapped().last_used = now;
+				artobject_lru.splice(artobject_lru.begin(), artobject_lru, node.mapped().lru);
+
+				auto form = node.mapped().form;
+				artobject_cache.insert(std::move(node));
+				return form;
+			}
+		}
+
+		if (base_artobject)
+		{
+			if (auto dupe = base_artobject->CreateDuplicateForm(false, nullptr))
+			{
+				auto temp = dupe->As<BGSArtObject>();
+				auto it = artobject_cache
+							  .emplace(std::string(a_model_path), CachedArtForm{ temp, {}, now })
+							  .first;
+				temp->SetModel(it->first.c_str());
+
+				artobject_lru.push_front(&it->first);
+				it->second.lru = artobject_lru.begin();
+				return temp;
+			}
+			else { SKSE::log::error("error creating form for: {}", a_model_path); }
+		}
+		else { SKSE::log::error("base ArtObject not found"); }
+
+		return nullptr;
+	}
+
+	NiAVObject* ArtAddonManager::GetMaster(std::string_view a_model_path)
+	{
+		// masters may only be touched from the thread that runs Update
+		if (!IsMainThread()) { return nullptr; }
+		auto it = masters.find(a_model_path);
+		return it != masters.end() ? it->second.get() : nullptr;
+	}
+
+	bool ArtAddonManager::IsMainThread() const
+	{
+		return std::this_thread::get_id() == main_thread.load(std::memory_order_relaxed);
 	}
 
-	int ArtAddonManager::GetNextId() { return next_id--; }
+	int ArtAddonManager::GetNextId() { return next_id.fetch_sub(1, std::memory_order_relaxed); }
 
 	ArtAddonManager::ArtAddonManager()
 	{
@@ -9,18 +9,25 @@ namespace backpack
 	RE::TESObjectREFR* g_marker_disable_objref = nullptr;
 	float              g_default_factivatepicklength = 180;
 
-	// random
-	const uint16_t g_ID_upper = 51261;
-	const uint16_t g_ID_lower = 10807;
-
 	uint16_t SetOrGetID(RE::TESObjectREFR* a_obj);
-	void     AddTransformData(RE::ExtraDataList* a_edl, RE::NiTransform& a_transform);
 
 	void Controller::DebugSummonPlayerPack()
 	{
-		auto bp = std::find_if(backpacks.begin(), backpacks.end(),
-			[](const Backpack& obj) { return obj.GetWearerID() == kPlayerForm; });
-		if (bp != backpacks.end()) { bp->StateTransition(Backpack::State::kGrabbed); }
+		if (auto bp = GetBackpackByWearer(kPlayerForm))
+		{
+			bp->StateTransition(Backpack::State::kGrabbed);
+		}
+	}
+
+	void Controller::RebuildBackpackIndex()
+	{
+		backpack_index.clear();
+		watched_wearers = 0;
+		for (std::size_t i = 0; i < backpacks.size(); i++)
+		{
+			backpack_index[backpacks[i].GetWearerID()] = i;
+			watched_wearers |= WatchBit(backpacks[i].GetWearerID());
+		}
 	}
 
 	void Controller::OnHiggsDrop(bool isLeft, RE::TESObjectREFR* droppedRefr)
@@ -63,9 +70,8 @@ namespace backpack
 		}
 		else
 		{  // Stop grabbing
-			auto bp = std::find_if(backpacks.begin(), backpacks.end(),
-				[](const Backpack& obj) { return obj.GetWearerID() == kPlayerForm; });
-			if (bp != backpacks.end() && bp->GetState() == Backpack::State::kGrabbed)
+			auto bp = GetBackpackByWearer(kPlayerForm);
+			if (bp && bp->GetState() == Backpack::State::kGrabbed)
 			{
 				bp->StateTransition(Backpack::State::kActive);
 			}
@@ -106,203 +112,200 @@ namespace backpack
 
 	void Controller::OnContainerChanged(const RE::TESContainerChangedEvent* event)
 	{
+		// Most container changes in the game (merchants, NPCs looting) don't involve a backpack
+		if (!(watched_wearers & (WatchBit(event->newContainer) | WatchBit(event->oldContainer))))
+		{
+			return;
+		}
+
+		auto bp = GetBackpackByWearer(event->newContainer);
+		auto bp_remove = GetBackpackByWearer(event->oldContainer);
+
+		// Inventory mirrors are kept in sync even while the backpack is disabled
+		auto bound_obj = TESForm::LookupByID<TESBoundObject>(event->baseObj);
+		if (bp) { bp->OnInventoryChanged(bound_obj, event->itemCount); }
+		if (bp_remove) { bp_remove->OnInventoryChanged(bound_obj, -event->itemCount); }
+
 		// Check for items added to visible backpacks, or player backpack
-		auto bp = std::find_if(backpacks.begin(), backpacks.end(),
-			[event](const Backpack& obj) { return obj.GetWearerID() == event->newContainer; });
-		if (bp != backpacks.end() &&
+		if (bp &&
 			(bp->GetState() != Backpack::State::kDisabled || bp->GetWearerID() == kPlayerForm))
 		{
 			_DEBUGLOG("item added to backpack: formid {:x} count {} uid {}", event->baseObj,
 				event->itemCount, event->uniqueID);
 
-			if (auto form = TESForm::LookupByID(event->baseObj))
+			if (bound_obj)
 			{
-				if (auto bound_obj = form->As<TESBoundObject>())
+				// Determine InventoryEntry
+				if (auto entry = bp->GetInventory().Find(bound_obj))
 				{
-					// Determine InventoryEntry
-					auto inv = bp->GetWearer()->GetInventory();
-					auto it = inv.find(bound_obj);
-					if (it != inv.end())
-					{
-						auto&              entry = it->second.second;
-						RE::ExtraDataList* target_extra_list = nullptr;
+					RE::ExtraDataList* target_extra_list = nullptr;
 
-						// If there are multiple extra lists, find one that matches
-						if (auto extra = entry->extraLists)
+					// If there are multiple extra lists, find one that matches
+					if (auto extra = entry->GetExtraLists())
+					{
+						for (auto edata : *extra)
 						{
-							for (auto edata : *extra)
-							{
-								_DEBUGLOG("  extra name: {} count: {}",
-									edata->GetDisplayName(bound_obj), edata->GetCount());
+							_DEBUGLOG("  extra name: {} count: {}",
+								edata->GetDisplayName(bound_obj), edata->GetCount());
 
-								// If we have an ID, use that
-								if (event->uniqueID)
+							// If we have an ID, use that
+							if (event->uniqueID)
+							{
+								if (auto ID = edata->GetByType<RE::ExtraUniqueID>())
 								{
-									if (auto ID = edata->GetByType<RE::ExtraUniqueID>())
+									if (ID->uniqueID == event->uniqueID)
 									{
-										if (ID->uniqueID == event->uniqueID)
-										{
-											target_extra_list = edata;
-											_DEBUGLOG(
-												"matching EDL found based on UID {}", ID->uniqueID);
-										}
+										target_extra_list = edata;
+										_DEBUGLOG(
+											"matching EDL found based on UID {}", ID->uniqueID);
 									}
 								}
-								// Criteria: not equipped, not favorited, no transform, at least itemCount
-								else if (edata->GetCount() >= event->itemCount &&
-									!edata->HasType(RE::ExtraDataType::kEditorRefMoveData) &&
-									!edata->HasType(RE::ExtraDataType::kHotkey) &&
-									!edata->HasType(RE::ExtraDataType::kWorn) &&
-									!edata->HasType(RE::ExtraDataType::kWornLeft))
-								{
-									target_extra_list = edata;
-									_DEBUGLOG("matching EDL found");
-								}
-								else { _DEBUGLOG("EDL found but did not match"); }
 							}
+							// Criteria: not equipped, not favorited, not placed, at least itemCount
+							else if (edata->GetCount() >= event->itemCount &&
+								!edata->HasType(RE::ExtraDataType::kEditorRefMoveData) &&
+								!GetLayout(bp->GetWearerID()).Find(bound_obj, edata) &&
+								!edata->HasType(RE::ExtraDataType::kHotkey) &&
+								!edata->HasType(RE::ExtraDataType::kWorn) &&
+								!edata->HasType(RE::ExtraDataType::kWornLeft))
+							{
+								target_extra_list = edata;
+								_DEBUGLOG("matching EDL found");
+							}
+							else { _DEBUGLOG("EDL found but did not match"); }
 						}
+					}
 
-						// Determine item source
-						auto            source = ItemSource::kLoot;
-						RE::NiTransform local;
-						bool            isLeft = false;
-
-						if (event->oldContainer == 0)
-						{  // Only look for transform data if the item came from the world
-							auto new_item_data = std::find_if(pending_items.begin(),
-								pending_items.end(), [event](const NewItemEvent& e) {
-									return e.baseObj == event->baseObj && e.ID == event->uniqueID;
-								});
+					// Determine item source
+					auto            source = ItemSource::kLoot;
+					RE::NiTransform local;
+					bool            isLeft = false;
 
-							if (new_item_data != pending_items.end())
+					if (event->oldContainer == 0)
+					{  // Only look for transform data if the item came from the world
+						auto it = pending_items.find(PendingKey(event->baseObj, event->uniqueID));
+						if (it != pending_items.end())
+						{
+							auto& new_item_data = it->second;
+							// Check transform data. if intialized, came from backpack. otherwise came from grid
+							if (new_item_data.local.translate == RE::NiPoint3::Zero())
 							{
-								// Check transform data. if intialized, came from backpack. otherwise came from grid
-								if (new_item_data->local.translate == RE::NiPoint3::Zero())
-								{
-									source = ItemSource::kGrid;
-								}
-								else
-								{
-									source = ItemSource::kManual;
-									local = new_item_data->local;
-								}
-								isLeft = new_item_data->isLeft;
-								pending_items.erase(new_item_data);
+								source = ItemSource::kGrid;
 							}
-							else { source = ItemSource::kPickup; }
-						}
-						_DEBUGLOG("  Source: {}", (int)source);
+							else
+							{
+								source = ItemSource::kManual;
+								local = new_item_data.local;
+							}
+							isLeft = new_item_data.isLeft;
 
-						if (event->newContainer != kPlayerForm && source != ItemSource::kManual)
-						{  // If this is an NPC backpack, we don't care about dropping items
-							source = ItemSource::kGrid;
+							// The item arrived, its ID can be handed out again
+							item_ids.Release(new_item_data.ID);
+							pending_items.erase(it);
 						}
+						else { source = ItemSource::kPickup; }
+					}
+					_DEBUGLOG("  Source: {}", (int)source);
+
+					if (event->newContainer != kPlayerForm && source != ItemSource::kManual)
+					{  // If this is an NPC backpack, we don't care about dropping items
+						source = ItemSource::kGrid;
+					}
 
-						View* destination = nullptr;
-						switch (source)
+					View* destination = nullptr;
+					switch (source)
+					{
+					case ItemSource::kLoot:
+						if (settings.newitems_drop_on_loot)
 						{
-						case ItemSource::kLoot:
-							if (settings.newitems_drop_on_loot)
-							{
-								if (!menuchecker::isGameStopped() || settings.newitems_drop_paused)
-								{
-									auto count = event->itemCount;
-									SKSE::GetTaskInterface()->AddTask(
-										[this, bound_obj, target_extra_list, count]() {
-											this->DropItemToHandOrGround(bound_obj,
-												target_extra_list, count,
-												settings.newitems_drop_to_ground);
-										});
-									break;
-								}
-							}
-						case ItemSource::kPickup:
-							if (settings.newitems_drop_on_pickup && source != ItemSource::kLoot)
+							if (!menuchecker::isGameStopped() || settings.newitems_drop_paused)
 							{
 								auto count = event->itemCount;
 								SKSE::GetTaskInterface()->AddTask(
 									[this, bound_obj, target_extra_list, count]() {
-										this->DropItemToHandOrGround(bound_obj, target_extra_list,
-											count, settings.newitems_drop_to_ground);
+										this->DropItemToHandOrGround(bound_obj,
+											target_extra_list, count,
+											settings.newitems_drop_to_ground);
 									});
 								break;
 							}
-						case ItemSource::kGrid:
-							if (bp->GetState() != Backpack::State::kDisabled)
-							{
-								if (!settings.disable_grid)
-								{  // Add to grid
-									if (auto grid = bp->GetViewByName(GridView::kNodeName))
-									{  // Just refresh the grid view
-										grid->Filter(
-											[](const RE::TESBoundObject* obj) { return true; });
-
-										// Remove our UID
-										if (target_extra_list &&
-											target_extra_list->HasType<RE::ExtraUniqueID>())
-										{
-											target_extra_list->RemoveByType(
-												RE::ExtraDataType::kUniqueID);
-										}
+						}
+					case ItemSource::kPickup:
+						if (settings.newitems_drop_on_pickup && source != ItemSource::kLoot)
+						{
+							auto count = event->itemCount;
+							SKSE::GetTaskInterface()->AddTask(
+								[this, bound_obj, target_extra_list, count]() {
+									this->DropItemToHandOrGround(bound_obj, target_extra_list,
+										count, settings.newitems_drop_to_ground);
+								});
+							break;
+						}
+					case ItemSource::kGrid:
+						if (bp->GetState() != Backpack::State::kDisabled)
+						{
+							if (!settings.disable_grid)
+							{  // Add to grid
+								if (auto grid = bp->GetViewByName(GridView::kNodeName))
+								{  // Next free grid slot, or the Container once the grid is full
+									grid->AddItemEx(bound_obj, target_extra_list, event->itemCount);
+
+									// Remove our UID, IDs from the game and layout keys stay
+									auto uid = target_extra_list ?
+										target_extra_list->GetByType<RE::ExtraUniqueID>() :
+										nullptr;
+									if (uid && helper::IDAllocator::Owns(uid->uniqueID))
+									{
+										target_extra_list->RemoveByType(
+											RE::ExtraDataType::kUniqueID);
 									}
-									break;
-								}
-								else if (destination = bp->GetViewByName(NormalView::kNodeName);
-										 destination)
-								{  // Auto-add to natural view
-									local.translate = ((NormalView*)destination)
-														  ->FindNextAvailableSlot(bound_obj);
 								}
+								break;
+							}
+							else if (destination = bp->GetViewByName(NormalView::kNodeName);
+									 destination)
+							{  // Auto-add to natural view
+								local.translate = ((NormalView*)destination)
+													  ->FindNextAvailableSlot(bound_obj);
 							}
-						case ItemSource::kManual:
-							if (bp->GetState() != Backpack::State::kDisabled)
+						}
+					case ItemSource::kManual:
+						if (bp->GetState() != Backpack::State::kDisabled)
+						{
+							if (auto view = bp->GetActiveView(isLeft))
 							{
-								if (auto view = bp->GetActiveView(isLeft))
+								destination = view;
+								if (std::strcmp(view->GetName(), Holster::kNodeName) == 0)
 								{
-									destination = view;
-									if (std::strcmp(view->GetName(), Holster::kNodeName) == 0)
-									{
-										local.translate = RE::NiPoint3::Zero();
-										local.rotate.SetEulerAnglesXYZ(helper::deg2rad(90), 0, 0);
-									}
+									local.translate = RE::NiPoint3::Zero();
+									local.rotate.SetEulerAnglesXYZ(helper::deg2rad(90), 0, 0);
 								}
-								if (auto model = helper::GetObjectModelPath(bound_obj);
-									model && destination)
-								{
-									destination->AddItem(
-										Item(bound_obj, event->itemCount, target_extra_list,
-											art_addon::ArtAddon::Make(model, bp->GetObjectRefr(),
-												destination->GetRoot(), local)));
+							}
+							if (auto model = FormInfoCache::GetSingleton()->Get(bound_obj).model;
+								model && destination)
+							{
+								destination->AddItem(
+									Item(bound_obj, event->itemCount, target_extra_list,
+										art_addon::ArtAddon::Make(model, bp->GetObjectRefr(),
+											destination->GetRoot(), local)));
 
-									// Write transform to extradata
-									if (target_extra_list)
+								// Remember the placement, the layout key replaces our UID
+								if (target_extra_list)
+								{
+									GetLayout(bp->GetWearerID())
+										.Record(bound_obj, target_extra_list,
+											destination->PackPose(local));
+								}
+								else
+								{  // If the entry doesn't have any extradata, we have to create it in this hack way
+									auto changes = bp->GetWearer()->GetInventoryChanges();
+									if (changes && entry->changes)
 									{
-										auto temp = new RE::ExtraEditorRefMoveData();
-										temp->realLocation = local.translate;
-										local.rotate.ToEulerAnglesXYZ(temp->realAngle);
-										target_extra_list->Add(temp);
-
-										// Remove our UID
-										if (target_extra_list->HasType<RE::ExtraUniqueID>())
-										{
-											target_extra_list->RemoveByType(
-												RE::ExtraDataType::kUniqueID);
-										}
-
-										auto temp2 = new RE::ExtraHealth();
-										temp2->health = 0.69;
-										target_extra_list->Add(temp2);
-									}
-									else
-									{  // If the entry doesn't have any extradata, we have to create it in this hack way
-										if (auto changes = bp->GetWearer()->GetInventoryChanges())
-										{
-											changes->SetFavorite(entry.get(), nullptr);
-											event_queue.push_back(
-												std::make_unique<CreateExtraDataEvent>(
-													entry.get(), event->itemCount, local));
-											_DEBUGLOG("Sending ExtraData Event");
-										}
+										changes->SetFavorite(entry->changes, nullptr);
+										PushUIEvent<CreateExtraDataEvent>(entry->changes,
+											event->itemCount, destination->PackPose(local),
+											bp->GetWearerID());
+										_DEBUGLOG("Sending ExtraData Event");
 									}
 								}
 							}
@@ -313,29 +316,12 @@ namespace backpack
 		}
 
 		// Check for items removed from visible backpacks
-		auto bp_remove = std::find_if(backpacks.begin(), backpacks.end(),
-			[event](const Backpack& obj) { return obj.GetWearerID() == event->oldContainer; });
-		if (bp_remove != backpacks.end() && bp_remove->GetState() != Backpack::State::kDisabled)
+		if (bp_remove && bp_remove->GetState() != Backpack::State::kDisabled)
 		{
 			_DEBUGLOG("item removed from backpack: formid {:x} count {}", event->baseObj,
 				event->itemCount);
 
-			// TODO: To determine which Item was removed, we need to find all Items in all Views
-			// with matching formID and use process of elimination
-
-			// Find the View it was removed from and delete the corresponding Item
-			for (auto& v : bp_remove->GetViews())
-			{
-				auto& items = v->GetItems();
-				auto  it = std::find_if(items.begin(), items.end(),
-					 [&](const Item& i) { return i.base->formID == event->baseObj; });
-
-				if (it != items.end())
-				{
-					_DEBUGLOG("  matching baseobj found: {}", it->base->GetName());
-					items.erase(it);
-				}
-			}
+			if (bound_obj) { bp_remove->OnItemsRemoved(bound_obj, event->itemCount); }
 		}
 	}
 
@@ -345,9 +331,8 @@ namespace backpack
 		if (event->baseObject == g_backpack_formID)
 		{
 			// check if we already have a backpack for this npc
-			auto it = std::find_if(backpacks.begin(), backpacks.end(),
-				[event](const Backpack& obj) { return obj.GetWearer() == event->actor.get(); });
-			if (it != backpacks.end())
+			auto bp = event->actor ? GetBackpackByWearer(event->actor->GetFormID()) : nullptr;
+			if (bp)
 			{
 				if (event->equipped)
 				{
@@ -355,8 +340,23 @@ namespace backpack
 				}
 				else
 				{
-					// backpack was removed, destroy virtual backpack
-					backpacks.erase(it);
+					// backpack was removed, destroy virtual backpack. The erase shifts the later
+					// backpacks, so the selections are found again by wearer
+					RE::FormID selected_wearer[2] = {};
+					for (int i = 0; i < 2; i++)
+					{
+						if (selected_backpack[i] && selected_backpack[i] != bp)
+						{
+							selected_wearer[i] = selected_backpack[i]->GetWearerID();
+						}
+					}
+					backpacks.erase(backpacks.begin() + (bp - backpacks.data()));
+					RebuildBackpackIndex();
+					for (int i = 0; i < 2; i++)
+					{
+						selected_backpack[i] =
+							selected_wearer[i] ? GetBackpackByWearer(selected_wearer[i]) : nullptr;
+					}
 				}
 			}
 			else
@@ -372,50 +372,170 @@ namespace backpack
 		else if (event->equipped && 0) {}
 		// If the item was unequipped by an actor whose backpack is currently open, add it to the View
 		else if (!event->equipped && 0) {}
+
+		// Equipped is one of the Item categories that filters use
+		if (event->actor && event->baseObject != g_backpack_formID)
+		{
+			if (auto bp = GetBackpackByWearer(event->actor->GetFormID()))
+			{
+				bp->OnItemFlagsChanged(event->baseObject);
+			}
+		}
 	}
 
 	void Controller::PostWandUpdate()
 	{
+		frame++;
+		UpdateFrameInput();
 		ProcessInput();
 		ProcessEvents();
+		ExpirePendingItems();
+	}
+
+	void Controller::ExpirePendingItems()
+	{
+		for (auto it = pending_items.begin(); it != pending_items.end();)
+		{
+			if ((int32_t)(frame - it->second.expiry_frame) >= 0)
+			{
+				_DEBUGLOG("pending item {:x} ID {} expired", it->second.baseObj, it->second.ID);
+				item_ids.Release(it->second.ID);
+				it = pending_items.erase(it);
+			}
+			else { ++it; }
+		}
+	}
+
+	void Controller::OnGameSaved(SKSE::SerializationInterface* a_intfc)
+	{
+		for (auto& [wearer, table] : GetSingleton()->layouts)
+		{
+			table.Prune(RE::TESForm::LookupByID<RE::TESObjectREFR>(wearer));
+			if (!table.Size()) { continue; }
+
+			if (!a_intfc->OpenRecord(kLayoutRecord, kLayoutVersion) ||
+				!table.Save(a_intfc, wearer))
+			{
+				SKSE::log::error("failed to save item layout of {:x}", wearer);
+			}
+		}
+	}
+
+	void Controller::OnGameLoaded(SKSE::SerializationInterface* a_intfc)
+	{
+		auto     controller = GetSingleton();
+		uint32_t type, version, length;
+		while (a_intfc->GetNextRecordInfo(type, version, length))
+		{
+			if (type != kLayoutRecord) { continue; }
+			if (version != kLayoutVersion)
+			{
+				SKSE::log::trace("skipping item layout record version {}", version);
+				continue;
+			}
+
+			auto wearer = LayoutTable::ReadWearer(a_intfc);
+			if (!wearer || length < sizeof(RE::FormID) ||
+				!controller->layouts[wearer].Load(a_intfc, length - (uint32_t)sizeof(RE::FormID)))
+			{
+				SKSE::log::error("failed to load item layout of {:x}", wearer);
+				continue;
+			}
+			_DEBUGLOG("loaded item layout of {:x}: {} stacks", wearer,
+				controller->layouts[wearer].Size());
+		}
+	}
+
+	void Controller::OnRevert(SKSE::SerializationInterface*)
+	{
+		// the tables are cleared, not erased, Views keep pointers to them
+		for (auto& [wearer, table] : GetSingleton()->layouts) { table.Clear(); }
+
+		// the model paths of created forms go away with them, and their FormIDs are reused
+		FormInfoCache::GetSingleton()->Clear();
+
+		// spare hover models from the session being unloaded
+		art_addon::ArtAddonPool::GetSingleton()->Clear();
+	}
+
+	void Controller::UpdateFrameInput()
+	{
+		for (auto isLeft : { false, true })
+		{
+			auto& hand = frame_input.hands[isLeft];
+			hand = {};
+
+			if (auto node = vrinput::GetHandNode(isLeft, backpackvr::g_use_firstperson))
+			{
+				hand.node = node;
+				hand.rotation = node->world.rotate;
+				hand.position = node->world.translate + node->world.rotate * vrinput::g_palm_offset;
+			}
+
+			hand.trigger =
+				vrinput::GetTrigger(isLeft ? vrinput::Hand::kLeft : vrinput::Hand::kRight);
+
+			if (g_higgsInterface)
+			{
+				if (g_higgsInterface->IsHandInGrabbableState(isLeft))
+				{
+					hand.state = HandState::kEmpty;
+				}
+				else if (hand.grabbed = g_higgsInterface->GetGrabbedObject(isLeft); hand.grabbed)
+				{
+					// TODO: check here if object is depositable in inventory
+					hand.state = HandState::kGrabbing;
+				}
+				else if (settings.allow_equip_swapping) { hand.state = HandState::kWeapon; }
+			}
+		}
 	}
 
 	void Controller::ProcessInput()
 	{
 		std::vector<Backpack*> process;
 
+		// Item spawning from every backpack's Init shares one budget per frame
+		auto load_deadline = std::chrono::steady_clock::now() +
+			std::chrono::microseconds(settings.load_budget_us);
+
 		// Broad phase checking of backpacks location
 		for (auto& bp : backpacks)
 		{
 			if (bp.GetState() != Backpack::State::kDisabled)
 			{
 				if (!bp.IsInit()) { bp.Init(); }
+				if (bp.IsLoading()) { bp.ContinueInit(load_deadline); }
 
 				if (bp.GetState() == Backpack::State::kGrabbed) { bp.MoveGrabbed(); }
-				else if (bp.CheckInteractDistance())
+				else
 				{
-					bp.StateTransition(Backpack::State::kActive);
-					process.push_back(&bp);
+					bp.UpdateProximity(frame);
+					if (bp.GetState() == Backpack::State::kActive) { process.push_back(&bp); }
 				}
-				else if (bp.CheckShutoffDistance()) { bp.StateTransition(Backpack::State::kIdle); }
-				else { bp.StateTransition(Backpack::State::kDisabled); }
+
+				bp.UpdateLOD();
+				for (auto& v : bp.GetViews()) { v->ApplyFilter(); }
 			}
 		}
 
 		// Do processing of hand positions to determine interaction events
 		for (auto bp : process)
 		{
+			RE::NiPoint3 hand_pos[2];
+			View*        hand_view[2] = { nullptr, nullptr };
+
 			for (auto isLeft : { true, false })
 			{
-				auto state = GetHandState(isLeft);
+				auto& hand = frame_input.hands[isLeft];
 
-				switch (state)
+				switch (hand.state)
 				{
 				case HandState::kGrabbing:
 
-					if (auto grabref = g_higgsInterface->GetGrabbedObject(isLeft))
+					if (auto grab3D = hand.grabbed->GetCurrent3D())
 					{
-						if (bp->PickActiveView(grabref->GetCurrent3D()->worldBound.center, isLeft))
+						if (bp->PickActiveView(grab3D->worldBound.center, isLeft))
 						{
 							selected_backpack[isLeft] = bp;
 						}
@@ -425,16 +545,12 @@ namespace backpack
 				case HandState::kWeapon:
 				case HandState::kEmpty:
 					{
-						if (auto view = bp->PickActiveView(
-								vrinput::GetHandPosition(isLeft, backpackvr::g_use_firstperson),
-								isLeft))
+						hand_pos[isLeft] = hand.position;
+
+						if (auto view = bp->PickActiveView(hand_pos[isLeft], isLeft))
 						{
 							selected_backpack[isLeft] = bp;
-
-							if (auto item = view->PickActiveItem(
-									vrinput::GetHandPosition(isLeft, backpackvr::g_use_firstperson),
-									isLeft))
-							{}
+							hand_view[isLeft] = view;
 						}
 					}
 					break;
@@ -442,6 +558,16 @@ namespace backpack
 					break;
 				}
 			}
+
+			// Pick items for both hands in one pass when they are in the same View
+			if (hand_view[0])
+			{
+				hand_view[0]->PickActiveItems(hand_pos, hand_view[1] == hand_view[0] ? 3 : 1);
+			}
+			if (hand_view[1] && hand_view[1] != hand_view[0])
+			{
+				hand_view[1]->PickActiveItems(hand_pos, 2);
+			}
 		}
 
 		// Update rollover UI
@@ -462,145 +588,187 @@ namespace backpack
 	}
 
 	void Controller::ProcessEvents()
+	{
+		// Handlers may push more events (e.g. a View going idle resets its Items), those are
+		// processed in the same loop as another batch
+		UIEvent event;
+		while (!event_queue.Empty())
+		{
+			// Merge everything queued so far so only net hover changes reach the visuals
+			event_batch.Clear();
+			while (event_queue.Pop(event)) { event_batch.Add(event); }
+
+			event_stats.received += event_batch.Received();
+			event_stats.applied += event_batch.Size();
+
+			event_batch.ForEach([this](const UIEvent& e) {
+				std::visit([this](const auto& e) { OnUIEvent(e); }, e);
+			});
+		}
+
+		static std::size_t reported_drops = 0;
+		if (event_queue.Overflows() != reported_drops)
+		{
+			reported_drops = event_queue.Overflows();
+			_DEBUGLOG("UI event queue full, {} events dropped in total", reported_drops);
+		}
+	}
+
+	void Controller::OnUIEvent(const ViewHoverEvent& e)
 	{
 		// TODO: temporary - effect on hand to show View overlap
-		static art_addon::ArtAddonPtr handfx[2];
+		if (e.new_state == View::State::kActive)
+		{
+			NiTransform temp;
+			hand_effect[e.isLeft] = art_addon::ArtAddon::MakePooled("HelperSphere.nif",
+				RE::PlayerCharacter::GetSingleton(), frame_input.hands[e.isLeft].node, temp);
+		}
+		else if (e.new_state == View::State::kIdle)
+		{
+			// When a View goes out of focus, we need to set all its Items to idle..
+			for (auto& i : e.view->GetItems()) { i.SetState(e.isLeft, Item::State::kIdle); }
+			hand_effect[e.isLeft].reset();
+		}
+	}
 
-		while (!event_queue.empty())
+	void Controller::OnUIEvent(const ItemHoverEvent& e)
+	{
+		_DEBUGLOG("Item hover event: {}  {} on {}", e.isLeft ? "left" : "right",
+			e.new_state == Item::State::kActive      ? "active" :
+				e.new_state == Item::State::kHovered ? "hovered" :
+														"idle",
+			e.item->base->GetName());
+
+		if (selected_backpack[e.isLeft])
 		{
-			auto event = event_queue.front().get();
-			switch (event->type())
+			if (e.old_state == Item::State::kActive)
 			{
-			case UIEvent::Type::ViewHovered:
+				// de-activate the rollover if there's no item selected for this hand
+				if (!(selected_backpack[e.isLeft]->GetActiveItem(e.isLeft)))
 				{
-					auto e = (ViewHoverEvent*)event;
-					if (e->new_state == View::State::kActive)
-					{
-						NiTransform temp;
-						handfx[e->isLeft] = art_addon::ArtAddon::Make("HelperSphere.nif",
-							RE::PlayerCharacter::GetSingleton(),
-							vrinput::GetHandNode(e->isLeft, backpackvr::g_use_firstperson), temp);
-					}
-					else if (e->new_state == View::State::kIdle)
-					{
-						// When a View goes out of focus, we need to set all its Items to idle..
-						for (auto& i : e->view->GetItems())
-						{
-							i.SetState(e->isLeft, Item::State::kIdle);
-						}
-						handfx[e->isLeft].reset();
-					}
+					_DEBUGLOG("    disable activator");
+					DisableActivator(selected_backpack[e.isLeft]);
 				}
-				break;
-			case UIEvent::Type::ItemHovered:
-				{
-					auto e = (ItemHoverEvent*)event;
-					_DEBUGLOG("Item hover event: {}  {} on {}", e->isLeft ? "left" : "right",
-						e->new_state == Item::State::kActive      ? "active" :
-							e->new_state == Item::State::kHovered ? "hovered" :
-																	"idle",
-						e->item->base->GetName());
-
-					if (selected_backpack[e->isLeft])
-					{
-						if (e->old_state == Item::State::kActive)
-						{
-							// de-activate the rollover if there's no item selected for this hand
-							if (!(selected_backpack[e->isLeft]->GetActiveItem(e->isLeft)))
-							{
-								_DEBUGLOG("    disable activator");
-								DisableActivator(selected_backpack[e->isLeft]);
-							}
-						}
+			}
 
-						switch (e->new_state)
-						{
-						case Item::State::kActive:
-							{
-								// do selection visuals
-								auto            item_model = e->item->model->Get3D();
-								RE::NiTransform temp;
-								temp.translate = item_model->world.rotate.Transpose() *
-									(item_model->worldBound.center - item_model->world.translate);
-								e->item->effects.clear();
-								e->item->effects.push_back(
-									art_addon::ArtAddon::Make("HelperSphere.nif",
-										selected_backpack[e->isLeft]->GetObjectRefr(), item_model,
-										temp, [](art_addon::ArtAddon* a) {
-											if (auto model = a->Get3D())
-											{
-												model->local.scale = 0.7;
-											}
-										}));
-
-								SetActivator(
-									selected_backpack[e->isLeft], e->item->base, e->isLeft);
-							}
-							break;
-						case Item::State::kHovered:
-							{
-								// do hover visuals
-								auto            item_model = e->item->model->Get3D();
-								RE::NiTransform temp;
-								temp.translate = item_model->world.rotate.Transpose() *
-									(item_model->worldBound.center - item_model->world.translate);
-								e->item->effects.clear();
-								e->item->effects.push_back(
-									art_addon::ArtAddon::Make("HelperSphere.nif",
-										selected_backpack[e->isLeft]->GetObjectRefr(), item_model,
-										temp, [](art_addon::ArtAddon* a) {
-											if (auto model = a->Get3D())
-											{
-												model->local.scale = 0.3;
-											}
-										}));
-							}
-							break;
-						case Item::State::kIdle:
-							e->item->effects.clear();
-							break;
-						}
-					}
+			switch (e.new_state)
+			{
+			case Item::State::kActive:
+				{
+					// do selection visuals
+					auto            item_model = e.item->model->Get3D();
+					RE::NiTransform temp;
+					temp.translate = item_model->world.rotate.Transpose() *
+						(item_model->worldBound.center - item_model->world.translate);
+					e.item->effects.clear();
+					e.item->effects.push_back(art_addon::ArtAddon::MakePooled("HelperSphere.nif",
+						selected_backpack[e.isLeft]->GetObjectRefr(), item_model, temp,
+						[](art_addon::ArtAddon* a) {
+							if (auto model = a->Get3D()) { model->local.scale = 0.7; }
+						}));
+
+					SetActivator(selected_backpack[e.isLeft], e.item->base, e.isLeft);
 				}
 				break;
-			case UIEvent::Type::CreateExtraDataEvent:
+			case Item::State::kHovered:
 				{
-					auto e = (CreateExtraDataEvent*)event;
-					if (e->entry)
-					{
-						if (auto list_of_lists = e->entry->extraLists)
-						{
-							if (auto edl = list_of_lists->front())
-							{
-								if (edl->HasType(RE::ExtraDataType::kHotkey))
-								{
-									edl->RemoveByType(RE::ExtraDataType::kHotkey);
-								}
-
-								AddTransformData(edl, e->local);
-							}
-						}
-					}
+					// do hover visuals
+					auto            item_model = e.item->model->Get3D();
+					RE::NiTransform temp;
+					temp.translate = item_model->world.rotate.Transpose() *
+						(item_model->worldBound.center - item_model->world.translate);
+					e.item->effects.clear();
+					e.item->effects.push_back(art_addon::ArtAddon::MakePooled("HelperSphere.nif",
+						selected_backpack[e.isLeft]->GetObjectRefr(), item_model, temp,
+						[](art_addon::ArtAddon* a) {
+							if (auto model = a->Get3D()) { model->local.scale = 0.3; }
+						}));
 				}
 				break;
-			default:
+			case Item::State::kIdle:
+				e.item->effects.clear();
 				break;
 			}
+		}
+	}
+
+	void Controller::OnUIEvent(const CreateExtraDataEvent& e)
+	{
+		if (e.entry)
+		{
+			if (auto list_of_lists = e.entry->extraLists)
+			{
+				if (auto edl = list_of_lists->front())
+				{
+					if (edl->HasType(RE::ExtraDataType::kHotkey))
+					{
+						edl->RemoveByType(RE::ExtraDataType::kHotkey);
+					}
 
-			event_queue.pop_front();
+					GetLayout(e.wearer).Record(e.entry->object, edl, e.pose);
+				}
+			}
 		}
 	}
 
-	HandState Controller::GetHandState(bool isLeft)
+	void UIEventBatch::Add(const UIEvent& a_event)
 	{
-		if (g_higgsInterface->IsHandInGrabbableState(isLeft)) { return HandState::kEmpty; }
-		else if (g_higgsInterface->GetGrabbedObject(isLeft))
+		received++;
+
+		uintptr_t key = 0;
+		std::visit(
+			[&key](const auto& e) {
+				using T = std::decay_t<decltype(e)>;
+				if constexpr (std::is_same_v<T, ItemHoverEvent>)
+				{
+					key = (uintptr_t)e.item | e.isLeft;
+				}
+				else if constexpr (std::is_same_v<T, ViewHoverEvent>)
+				{
+					key = (uintptr_t)e.view | e.isLeft;
+				}
+			},
+			a_event);
+
+		auto index = count++;
+		events[index] = a_event;
+		live.set(index);
+
+		if (!key) { return; }
+
+		// open addressing, the table is twice the batch size so it never fills up
+		auto slot = (key >> 3) * 0x9E3779B97F4A7C15ull % slots.size();
+		while (slots[slot].stamp == stamp && slots[slot].key != key)
 		{
-			// TODO: check here if object is depositable in inventory
-			return HandState::kGrabbing;
+			slot = (slot + 1) % slots.size();
 		}
-		else if (settings.allow_equip_swapping) { return HandState::kWeapon; }
-		return HandState::kInvalid;
+
+		if (slots[slot].stamp == stamp)
+		{  // keep the first old state and the latest new state, at the latest position
+			auto prev = slots[slot].index;
+			std::visit(
+				[](auto& merged, const auto& earlier) {
+					using T = std::decay_t<decltype(merged)>;
+					if constexpr (std::is_same_v<T, std::decay_t<decltype(earlier)>> &&
+						!std::is_same_v<T, CreateExtraDataEvent>)
+					{
+						merged.old_state = earlier.old_state;
+					}
+				},
+				events[index], events[prev]);
+			live.reset(prev);
+		}
+		slots[slot] = { key, (uint32_t)index, stamp };
+
+		// drop transitions that cancelled out
+		std::visit(
+			[this, index](const auto& e) {
+				if constexpr (!std::is_same_v<std::decay_t<decltype(e)>, CreateExtraDataEvent>)
+				{
+					if (e.old_state == e.new_state) { live.reset(index); }
+				}
+			},
+			events[index]);
 	}
 
 	void Controller::SetActivator(
@@ -674,45 +842,82 @@ namespace backpack
 		}
 	}
 
-	bool Backpack::CheckShutoffDistance()
+	void Backpack::OnItemFlagsChanged(RE::FormID a_base)
 	{
-		if (auto playerroot = RE::PlayerCharacter::GetSingleton()->GetCurrent3D())
+		if (auto refs = item_index->Find(a_base))
 		{
-			if (auto myroot = object->GetCurrent3D())
+			for (auto& ref : *refs)
 			{
-				if (wearer_ref_id == kPlayerForm)
-				{
-					return playerroot->world.translate.GetDistance(myroot->world.translate) <
-						Controller::GetSingleton()->GetSettings().shutoff_distance_player;
-				}
-				else
+				if (auto item = ref.view->GetItem(ref.handle))
 				{
-					return playerroot->world.translate.GetDistance(myroot->world.translate) <
-						Controller::GetSingleton()->GetSettings().shutoff_distance_npc;
+					item->UpdateCategories();
+					ref.view->RefreshFilter();
 				}
 			}
 		}
-		return false;
 	}
 
-	bool Backpack::CheckInteractDistance()
+	void Backpack::UpdateLOD()
 	{
-		if (auto playerroot = RE::PlayerCharacter::GetSingleton()->GetCurrent3D())
+		auto lod = Item::LOD::kCulled;
+
+		if (state == State::kActive || state == State::kGrabbed) { lod = Item::LOD::kFull; }
+		else if (auto myroot = object->GetCurrent3D())
 		{
-			if (auto myroot = object->GetCurrent3D())
+			auto  controller = Controller::GetSingleton();
+			auto& settings = controller->GetSettings();
+			auto& pos = myroot->world.translate;
+
+			float full_sq = settings.lod_full_distance * settings.lod_full_distance;
+			float proxy_sq = settings.lod_proxy_distance * settings.lod_proxy_distance;
+
+			if (controller->GetHandPosition(false).GetSquaredDistance(pos) < full_sq ||
+				controller->GetHandPosition(true).GetSquaredDistance(pos) < full_sq)
 			{
-				static int c = 1;
-				if (c % 200 == 0)
-				{
-					SKSE::log::trace("root dist: {}",
-						playerroot->world.translate.GetDistance(myroot->world.translate));
-				}
-				return playerroot->world.translate.GetDistance(myroot->world.translate) <
-					Controller::GetSingleton()->GetSettings().min_interaction_distance;
+				lod = Item::LOD::kFull;
+			}
+			else if (auto playerroot = RE::PlayerCharacter::GetSingleton()->GetCurrent3D();
+					 playerroot && playerroot->world.translate.GetSquaredDistance(pos) < proxy_sq)
+			{
+				lod = Item::LOD::kProxy;
 			}
 		}
 
-		return false;
+		for (auto& v : views) { v->SetLOD(lod); }
+	}
+
+	void Backpack::UpdateProximity(uint32_t a_frame)
+	{
+		if (!proximity.Due(a_frame)) { return; }
+
+		// Without 3D the backpack is treated as out of range
+		auto distance_sq = std::numeric_limits<float>::max();
+		auto playerroot = RE::PlayerCharacter::GetSingleton()->GetCurrent3D();
+		auto myroot = object->GetCurrent3D();
+		if (playerroot && myroot)
+		{
+			distance_sq = playerroot->world.translate.GetSquaredDistance(myroot->world.translate);
+		}
+
+		auto&                             settings = Controller::GetSingleton()->GetSettings();
+		helper::ProximityScheduler::Bands bands;
+		bands.interact = settings.min_interaction_distance;
+		bands.interact_exit = settings.min_interaction_distance + settings.interaction_hysteresis;
+		bands.shutoff = wearer_ref_id == kPlayerForm ? settings.shutoff_distance_player :
+			settings.shutoff_distance_npc;
+
+		switch (proximity.Update(distance_sq, bands, a_frame))
+		{
+		case helper::ProximityScheduler::Zone::kNear:
+			StateTransition(State::kActive);
+			break;
+		case helper::ProximityScheduler::Zone::kMid:
+			StateTransition(State::kIdle);
+			break;
+		case helper::ProximityScheduler::Zone::kFar:
+			StateTransition(State::kDisabled);
+			break;
+		}
 	}
 
 	Item* View::GetActiveItem(bool isLeft)
@@ -797,6 +1002,23 @@ namespace backpack
 	{
 		if (state == a_state) { return; }
 
+		// grabbing and controller events change the state too, so the scheduler starts over from
+		// the new state. A released backpack is Active and keeps the wider exit band
+		using Zone = helper::ProximityScheduler::Zone;
+		switch (a_state)
+		{
+		case State::kDisabled:
+			proximity.Reset(Zone::kFar);
+			break;
+		case State::kIdle:
+			proximity.Reset(Zone::kMid);
+			break;
+		case State::kActive:
+		case State::kGrabbed:
+			proximity.Reset(Zone::kNear);
+			break;
+		}
+
 		// OnExit State event
 		switch (state)
 		{
@@ -821,6 +1043,10 @@ namespace backpack
 		case State::kDisabled:
 			{  // do shut off cleanup
 				views.clear();
+				item_index->Clear();
+				spawn_jobs.clear();
+				load_indicator.reset();
+				ModelBoundsCache::GetSingleton()->Save();
 				if (g_marker_disable_objref) { object->MoveTo(g_marker_disable_objref); }
 			}
 			break;
@@ -839,65 +1065,262 @@ namespace backpack
 		{
 			if (auto root = object->GetCurrent3D())
 			{
-				for (auto& c : root->AsNode()->GetChildren())
+				if (!AddBakedViews(root))
 				{
-					if (c->name.contains(NormalView::kNodeName))
-					{
-						views.push_back(std::make_unique<NormalView>(c.get()));
-					}
-					else if (c->name.contains(GridView::kNodeName))
-					{
-						views.push_back(std::make_unique<GridView>(c.get()));
-					}
-					else if (c->name.contains(Holster::kNodeName))
-					{
-						views.push_back(std::make_unique<Holster>(c.get()));
-					}
-					else if (c->name.contains(Handle::kNodeName))
+					for (auto& c : root->AsNode()->GetChildren())
 					{
-						views.push_back(std::make_unique<Handle>(c.get()));
+						AddView(c.get(), std::nullopt);
 					}
 				}
 
-				auto inv = wearer->GetInventory();
-				for (const auto& mapitem : inv)
+				item_index->Clear();
+				auto layout = &Controller::GetSingleton()->GetLayout(GetWearerID());
+				for (auto& view : views)
 				{
-					const auto& entry = mapitem.second.second;
-					int         count = mapitem.second.first;
+					view->SetIndex(item_index.get());
+					view->SetLayout(layout);
+				}
+				if (auto grid = static_cast<GridView*>(GetViewByName(GridView::kNodeName)))
+				{
+					grid->SetOverflow(
+						static_cast<NormalView*>(GetViewByName(NormalView::kNodeName)));
+				}
+
+				// Spawning every model at once drops frames on big inventories, so the Items are
+				// queued and spawned by ContinueInit
+				spawn_jobs.clear();
+				for (const auto& [obj, entry] : GetInventory().GetEntries())
+				{
+					int count = entry.count;
 
-					if (auto extra = entry->extraLists)
+					if (auto extra = entry.GetExtraLists())
 					{
 						for (auto extralist : *extra)
 						{
 							count -= extralist->GetCount();
-							for (auto& view : views)
-							{
-								if (view->AddItemEx(
-										entry->object, extralist, extralist->GetCount()))
-								{
-									_DEBUGLOG("{} added to {} : count = {} (extradata)",
-										extralist->GetDisplayName(entry->object), view->GetName(),
-										extralist->GetCount());
-									break;
-								}
-							}
+							spawn_jobs.push_back({ obj, extralist, extralist->GetCount(), 0 });
 						}
 					}
-					if (count)
+					if (count) { spawn_jobs.push_back({ obj, nullptr, count, 0 }); }
+				}
+
+				auto controller = Controller::GetSingleton();
+				for (auto& job : spawn_jobs)
+				{
+					job.dist_sq = std::numeric_limits<float>::max();
+					if (auto pos = GetSpawnPosition(job))
 					{
-						for (auto& view : views)
+						for (auto isLeft : { false, true })
 						{
-							if (view->AddItemEx(entry->object, nullptr, count))
-							{
-								_DEBUGLOG("{} added to {} : count = {}", entry->object->GetName(),
-									view->GetName(), count);
-								break;
-							}
+							job.dist_sq = std::min(job.dist_sq,
+								controller->GetHandPosition(isLeft).GetSquaredDistance(*pos));
 						}
 					}
 				}
+				std::sort(spawn_jobs.begin(), spawn_jobs.end(),
+					[](const SpawnJob& a, const SpawnJob& b) { return a.dist_sq > b.dist_sq; });
+
+				spawn_total = spawn_jobs.size();
+				_DEBUGLOG("backpack init: {} items queued", spawn_total);
+				UpdateLoadIndicator();
+			}
+		}
+	}
+
+	void Backpack::AddView(RE::NiAVObject* a_node, std::optional<RE::NiPoint3> a_extent)
+	{
+		if (a_node->name.contains(NormalView::kNodeName))
+		{
+			views.push_back(std::make_unique<NormalView>(a_node, a_extent));
+		}
+		else if (a_node->name.contains(GridView::kNodeName))
+		{
+			views.push_back(std::make_unique<GridView>(a_node, a_extent));
+		}
+		else if (a_node->name.contains(Holster::kNodeName))
+		{
+			views.push_back(std::make_unique<Holster>(a_node, a_extent));
+		}
+		else if (a_node->name.contains(Handle::kNodeName))
+		{
+			views.push_back(std::make_unique<Handle>(a_node));
+		}
+	}
+
+	bool Backpack::AddBakedViews(RE::NiAVObject* a_root)
+	{
+		auto& index = ModelBoundsCache::GetSingleton()->GetIndex();
+		auto  model = base ? FormInfoCache::GetSingleton()->Get(base).model : nullptr;
+		auto  record = model ? index.Find(model) : nullptr;
+		if (!record || !record->view_count) { return false; }
+
+		for (auto& baked : index.GetViews(*record))
+		{
+			std::string name(index.GetString(baked.name));
+			auto        node = a_root->GetObjectByName(name.c_str());
+			if (!node)
+			{
+				// the index is older than the mesh
+				SKSE::log::warn("nif index: no node {} in {}, rebake the index", name, model);
+				views.clear();
+				return false;
+			}
+
+			// the baker writes 0 when the node has no extent
+			std::optional<RE::NiPoint3> extent;
+			if (auto& e = baked.extent; e[0] || e[1] || e[2])
+			{
+				extent = RE::NiPoint3(e[0], e[1], e[2]);
+			}
+			AddView(node, extent);
+		}
+		return true;
+	}
+
+	void Backpack::ContinueInit(std::chrono::steady_clock::time_point a_deadline)
+	{
+		do
+		{
+			auto job = spawn_jobs.back();
+			spawn_jobs.pop_back();
+
+			// The inventory may have changed since Init, don't touch extra lists that are gone
+			bool valid = true;
+			if (job.extra)
+			{
+				valid = false;
+				auto entry = GetInventory().Find(job.obj);
+				if (auto lists = entry ? entry->GetExtraLists() : nullptr)
+				{
+					for (auto each : *lists)
+					{
+						if (each == job.extra) { valid = true; }
+					}
+				}
+			}
+
+			for (auto& view : views)
+			{
+				if (valid && view->AddItemEx(job.obj, job.extra, job.count))
+				{
+					_DEBUGLOG("{} added to {} : count = {}", job.obj->GetName(), view->GetName(),
+						job.count);
+					break;
+				}
+			}
+		} while (!spawn_jobs.empty() && std::chrono::steady_clock::now() < a_deadline);
+
+		UpdateLoadIndicator();
+	}
+
+	std::optional<RE::NiPoint3> Backpack::GetSpawnPosition(const SpawnJob& a_job)
+	{
+		for (auto& view : views)
+		{
+			if (view->CanAcceptObject(a_job.obj))
+			{
+				if (auto local = view->GetStoredTransform(a_job.obj, a_job.extra))
+				{
+					return view->GetRoot()->world * local->translate;
+				}
+				break;
+			}
+		}
+		return std::nullopt;
+	}
+
+	void Backpack::UpdateLoadIndicator()
+	{
+		if (spawn_jobs.empty())
+		{
+			load_indicator.reset();
+			return;
+		}
+
+		if (!load_indicator)
+		{
+			if (auto root = object->GetCurrent3D())
+			{
+				RE::NiTransform temp;
+				temp.translate.z = 30;
+				load_indicator = art_addon::ArtAddon::Make("HelperSphere.nif", object, root, temp);
+			}
+		}
+
+		// shrinks away as the Items come in
+		if (auto model = load_indicator ? load_indicator->Get3D() : nullptr)
+		{
+			model->local.scale = (float)spawn_jobs.size() / spawn_total;
+		}
+	}
+
+	const InventoryMirror& Backpack::GetInventory()
+	{
+		if (!inventory.IsSeeded()) { inventory.Seed(wearer); }
+		return inventory;
+	}
+
+	void Backpack::OnInventoryChanged(RE::TESBoundObject* a_obj, int a_delta)
+	{
+		inventory.Apply(wearer, a_obj, a_delta);
+	}
+
+	bool Backpack::DebugCheckInventory()
+	{
+		return wearer && GetInventory().DebugCheck(wearer);
+	}
+
+	void Backpack::OnItemsRemoved(RE::TESBoundObject* a_obj, int a_count)
+	{
+		auto refs = item_index->Find(a_obj->GetFormID());
+		if (!refs) { return; }
+
+		auto entry = GetInventory().Find(a_obj);
+		auto live = entry ? entry->GetExtraLists() : nullptr;
+		auto IsLive = [live](const RE::ExtraDataList* a_extra) {
+			if (live)
+			{
+				for (auto each : *live)
+				{
+					if (each == a_extra) { return true; }
+				}
+			}
+			return false;
+		};
+
+		// Removed extra lists may already be freed, they are only compared, never read
+		std::vector<ItemRef> removed;
+		for (auto& ref : *refs)
+		{
+			if (!entry || (ref.extra && !IsLive(ref.extra))) { removed.push_back(ref); }
+		}
+
+		if (removed.empty())
+		{  // every stack is still there, so one of them got smaller
+			for (auto& ref : *refs)
+			{
+				auto item = ref.view->GetItem(ref.handle);
+				if (!item) { continue; }
+
+				if (ref.extra && ref.extra->GetCount() < item->count)
+				{
+					item->count = ref.extra->GetCount();
+					break;
+				}
+				if (!ref.extra)
+				{
+					item->count -= a_count;
+					if (item->count <= 0) { removed.push_back(ref); }
+					break;
+				}
 			}
 		}
+
+		for (auto& ref : removed)
+		{
+			_DEBUGLOG("  removing {} from {}", a_obj->GetName(), ref.view->GetName());
+			ref.view->Remove(ref.handle);
+		}
 	}
 
 	View* Backpack::PickActiveView(const RE::NiPoint3& a_world_pos, bool isLeft)
@@ -919,7 +1342,8 @@ namespace backpack
 	{
 		if (state[isLeft] != a_new_state)
 		{
-			Controller::GetSingleton()->PushUIEvent<ViewHoverEvent>(a_new_state, isLeft, this);
+			Controller::GetSingleton()->PushUIEvent<ViewHoverEvent>(
+				a_new_state, state[isLeft], isLeft, this);
 
 			state[isLeft] = a_new_state;
 		}
@@ -937,16 +1361,6 @@ namespace backpack
 		return -1.f;
 	}
 
-	float Item::CheckOverlap(const RE::NiPoint3& a_world_pos)
-	{
-		if (model && model->Get3D())
-		{
-			auto dist = model->Get3D()->worldBound.center.GetDistance(a_world_pos);
-			if (dist < model->Get3D()->worldBound.radius) { return dist; }
-		}
-		return -1.f;
-	}
-
 	void Item::SetState(bool isLeft, State a_new_state)
 	{
 		if (state[isLeft] != a_new_state)
@@ -957,37 +1371,223 @@ namespace backpack
 		}
 	}
 
-	Item* View::PickActiveItem(const RE::NiPoint3& a_world_pos, bool isLeft)
+	bvh::Sphere Item::GetViewBound(const RE::NiAVObject* a_view_root) const
 	{
-		Item*                                selected = nullptr;
-		std::vector<std::pair<float, Item*>> narrow;
+		if (model && a_view_root)
+		{
+			if (auto node = model->Get3D())
+			{
+				return { a_view_root->world.rotate.Transpose() *
+							 (node->worldBound.center - a_view_root->world.translate),
+					node->worldBound.radius };
+			}
+		}
+		return {};
+	}
 
-		for (auto& i : items)
+	void Item::RecordModelBounds() const
+	{
+		auto path = FormInfoCache::GetSingleton()->Get(base).model;
+		auto node = model ? model->Get3D() : nullptr;
+		if (!path || !node) { return; }
+
+		auto cache = ModelBoundsCache::GetSingleton();
+		if (cache->Find(path)) { return; }
+
+		// measured in the model's own space, so the View's and Item's scale don't matter
+		auto        scale = node->world.scale > 0 ? node->world.scale : 1.f;
+		ModelBounds bounds;
+		bounds.center =
+			node->world.rotate.Transpose() * (node->worldBound.center - node->world.translate) /
+			scale;
+		bounds.radius = node->worldBound.radius / scale;
+		// the game doesn't keep a box around the 3D, the form's OBND is the closest thing
+		bounds.extents = (base->boundData.boundMax - base->boundData.boundMin) * 0.5f;
+		cache->Record(path, bounds);
+	}
+
+	uint32_t Item::ComputeCategories(RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra)
+	{
+		uint32_t categories = 0;
+		switch (a_base->GetFormType())
 		{
-			// broad phase
-			if (float dist = i.CheckOverlap(a_world_pos); dist > 0)
+		case RE::FormType::Weapon:
+			categories = Category::kWeapon;
+			break;
+		case RE::FormType::Armor:
+			categories = Category::kArmor;
+			break;
+		case RE::FormType::AlchemyItem:
+			categories = Category::kPotion;
+			break;
+		case RE::FormType::Ingredient:
+			categories = Category::kIngredient;
+			break;
+		case RE::FormType::Book:
+			categories = Category::kBook;
+			break;
+		case RE::FormType::Scroll:
+			categories = Category::kScroll;
+			break;
+		case RE::FormType::Ammo:
+			categories = Category::kAmmo;
+			break;
+		case RE::FormType::KeyMaster:
+			categories = Category::kKey;
+			break;
+		case RE::FormType::SoulGem:
+			categories = Category::kSoulGem;
+			break;
+		default:
+			categories = Category::kMisc;
+			break;
+		}
+
+		if (a_extra)
+		{
+			if (a_extra->HasType(RE::ExtraDataType::kWorn) ||
+				a_extra->HasType(RE::ExtraDataType::kWornLeft))
+			{
+				categories |= Category::kEquipped;
+			}
+			if (a_extra->HasType(RE::ExtraDataType::kHotkey)) { categories |= Category::kFavorite; }
+			if (a_extra->HasQuestObjectAlias()) { categories |= Category::kQuest; }
+
+			// Only direct ownership is checked, items owned by a faction the player is in count
+			// as stolen too
+			auto owner = a_extra->GetOwner();
+			if (owner && owner != RE::PlayerCharacter::GetSingleton()->GetActorBase())
 			{
-				narrow.push_back(std::make_pair(dist, &i));
+				categories |= Category::kStolen;
 			}
-			else { i.SetState(isLeft, Item::State::kIdle); }
 		}
+		return categories;
+	}
+
+	bool Item::SetLOD(LOD a_lod, RE::NiAVObject* a_view_root)
+	{
+		auto node = model ? model->Get3D() : nullptr;
+		if (!node) { return false; }
 
-		// find the closest item, set it to Active, set the rest to Hovered
-		if (!narrow.empty())
+		node->SetAppCulled(a_lod != LOD::kFull);
+
+		if (a_lod == LOD::kProxy && !proxy)
 		{
-			std::sort(narrow.begin(), narrow.end(),
-				[](const auto& a, const auto& b) { return a.first < b.first; });
+			RE::NiTransform temp;
+			temp.translate = GetViewBound(a_view_root).center;
+			temp.scale = kProxyScale;
+			proxy = art_addon::ArtAddon::MakePooled(
+				kProxyModel, RE::PlayerCharacter::GetSingleton(), a_view_root, temp);
+		}
+		else if (a_lod != LOD::kProxy) { proxy.reset(); }
 
-			selected = narrow.front().second;
-			selected->SetState(isLeft, Item::State::kActive);
+		lod = a_lod;
+		return true;
+	}
+
+	void View::UpdateItemBounds()
+	{
+		if (!items_changed && !items_moved && !unresolved_bounds) { return; }
 
-			for (size_t i = 1; i < narrow.size(); ++i)
+		// Item models are created asynchronously, so bounds can show up a few frames after the
+		// Item was added. Only a new or removed bound changes the tree topology
+		bool rebuild = items_changed;
+		int  unresolved = 0;
+		for (size_t i = 0; i < items.size(); i++)
+		{
+			auto& bound = item_bounds[i];
+			if (items_changed || items_moved || bound.radius <= 0)
 			{
-				narrow[i].second->SetState(isLeft, Item::State::kHovered);
+				auto old = bound;
+				bound = items[i].GetViewBound(root);
+				if (bound.radius <= 0) { unresolved++; }
+				else if (old.radius <= 0)
+				{
+					rebuild = true;
+					items[i].RecordModelBounds();
+				}
+
+				if (old.radius != bound.radius || old.center != bound.center)
+				{
+					OnItemBoundChanged(old, bound);
+				}
 			}
 		}
+		unresolved_bounds = unresolved;
 
-		return selected;
+		if (rebuild) { item_tree.Build(item_bounds); }
+		else { item_tree.Refit(item_bounds); }
+
+		if (items_changed)
+		{  // indices have shifted, find the Items that still need to be reset to idle
+			for (auto isLeft : { true, false })
+			{
+				picked[isLeft].clear();
+				for (uint32_t i = 0; i < items.size(); i++)
+				{
+					if (items[i].GetState(isLeft) != Item::State::kIdle)
+					{
+						picked[isLeft].push_back(i);
+					}
+				}
+			}
+		}
+
+		items_changed = false;
+		items_moved = false;
+	}
+
+	void View::PickActiveItems(const RE::NiPoint3 (&a_world_pos)[2], uint32_t a_hand_mask)
+	{
+		UpdateItemBounds();
+
+		auto         to_local = root->world.rotate.Transpose();
+		RE::NiPoint3 local[2] = { to_local * (a_world_pos[0] - root->world.translate),
+			to_local * (a_world_pos[1] - root->world.translate) };
+
+		// broad phase, both hands are tested in the same traversal
+		narrow[0].clear();
+		narrow[1].clear();
+		item_tree.Query(local, a_hand_mask, [this](uint32_t hand, uint32_t i, float dist_sq) {
+			narrow[hand].push_back(std::make_pair(dist_sq, i));
+		});
+
+		for (auto isLeft : { false, true })
+		{
+			if (!(a_hand_mask & (1 << isLeft))) { continue; }
+
+			auto& hits = narrow[isLeft];
+
+			// Items that were touched last update but no longer overlap go back to idle
+			for (auto i : picked[isLeft])
+			{
+				if (std::none_of(hits.begin(), hits.end(),
+						[i](const auto& each) { return each.second == i; }))
+				{
+					items[i].SetState(isLeft, Item::State::kIdle);
+				}
+			}
+
+			// find the closest item, set it to Active, set the rest to Hovered
+			picked[isLeft].clear();
+			if (!hits.empty())
+			{
+				auto closest = std::min_element(hits.begin(), hits.end(),
+					[](const auto& a, const auto& b) { return a.first < b.first; });
+
+				auto selected = &items[closest->second];
+				selected->SetState(isLeft, Item::State::kActive);
+
+				for (auto& [dist_sq, i] : hits)
+				{
+					if (&items[i] != selected)
+					{
+						items[i].SetState(isLeft, Item::State::kHovered);
+					}
+					picked[isLeft].push_back(i);
+				}
+			}
+		}
 	}
 
 	bool View::InventoryAddObject(
@@ -1040,28 +1640,127 @@ namespace backpack
 		return false;
 	}
 
-	void View::Filter(std::function<bool(const RE::TESBoundObject*)> filter) {}
+	void View::ApplyFilter()
+	{
+		if (!filter_dirty) { return; }
 
-	void GridView::Filter(std::function<bool(const RE::TESBoundObject*)> filter) {}
+		bool loading = false;
+		for (auto& item : items)
+		{
+			bool hide = !filter.Matches(item.categories);
+			if (hide == item.filtered_out || !item.model) { continue; }
+
+			if (auto node = item.model->Get3D())
+			{
+				node->UpdateMaterialAlpha(hide ? kFilteredAlpha : 1.f, false);
+				item.filtered_out = hide;
+			}
+			else { loading = true; }
+		}
+
+		// Keep retrying models that are still loading, but not forever
+		filter_dirty = loading && ++filter_retries < kFilterRetryFrames;
+	}
+
+	bool View::AddItem(const Item& a_item)
+	{
+		auto handle = next_handle++;
+		slots[handle] = (uint32_t)items.size();
+		items.push_back(a_item);
+		items.back().handle = handle;
+		item_bounds.emplace_back();
+		items_changed = true;
+		RefreshFilter();
+		if (lod != Item::LOD::kFull) { lod_pending = true; }
+
+		if (index) { index->Add(a_item.base->GetFormID(), { a_item.extradata, this, handle }); }
+		return true;
+	}
+
+	void View::ToggleVisible(bool a_visible)
+	{
+		visibility = a_visible ? VisibleState::kShow : VisibleState::kHide;
+		SetLOD(a_visible ? Item::LOD::kFull : Item::LOD::kCulled);
+	}
+
+	void View::SetLOD(Item::LOD a_lod)
+	{
+		if (visibility == VisibleState::kHide) { a_lod = Item::LOD::kCulled; }
+		if (a_lod == lod && !lod_pending) { return; }
+
+		lod = a_lod;
+		lod_pending = false;
+		for (auto& item : items)
+		{
+			if (item.lod != a_lod && !item.SetLOD(a_lod, root)) { lod_pending = true; }
+		}
+	}
+
+	void View::Remove(uint32_t a_handle)
+	{
+		auto it = slots.find(a_handle);
+		if (it == slots.end()) { return; }
+
+		auto slot = it->second;
+		slots.erase(it);
+		if (index) { index->Remove(items[slot].base->GetFormID(), this, a_handle); }
+		if (item_bounds[slot].radius > 0) { OnItemBoundChanged(item_bounds[slot], {}); }
+
+		// move the last Item into the freed slot so nothing else has to shift
+		if (slot != items.size() - 1)
+		{
+			items[slot] = std::move(items.back());
+			item_bounds[slot] = item_bounds.back();
+			slots[items[slot].handle] = slot;
+		}
+		items.pop_back();
+		item_bounds.pop_back();
+		items_changed = true;
+	}
+
+	void ItemIndex::Remove(RE::FormID a_base, const View* a_view, uint32_t a_handle)
+	{
+		auto it = by_base.find(a_base);
+		if (it == by_base.end()) { return; }
+
+		auto& refs = it->second;
+		std::erase_if(refs, [a_view, a_handle](const ItemRef& each) {
+			return each.view == a_view && each.handle == a_handle;
+		});
+		if (refs.empty()) { by_base.erase(it); }
+	}
+
+	std::optional<RE::NiTransform> View::GetStoredTransform(
+		RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra) const
+	{
+		if (!a_extra) { return std::nullopt; }
+		if (layout)
+		{
+			if (auto pose = layout->Find(a_base, a_extra)) { return UnpackPose(*pose); }
+		}
+
+		// saves from older versions kept the transform in the extra data, as XYZ Euler angles
+		if (auto local = a_extra->GetByType<RE::ExtraEditorRefMoveData>())
+		{
+			RE::NiTransform temp;
+			temp.translate = local->realLocation;
+			temp.rotate.SetEulerAnglesXYZ(local->realAngle);
+			return temp;
+		}
+		return std::nullopt;
+	}
 
 	bool View::AddItemEx(RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra, int count)
 	{
 		if (CanAcceptObject(a_base))
 		{
-			if (auto model = helper::GetObjectModelPath(a_base); model)
+			if (auto model = FormInfoCache::GetSingleton()->Get(a_base).model; model)
 			{
-				RE::NiTransform temp;
-				if (a_extra)
+				if (auto local = GetStoredTransform(a_base, a_extra))
 				{
-					if (auto local = a_extra->GetByType<RE::ExtraEditorRefMoveData>())
-					{
-						temp.translate = local->realLocation;
-						temp.rotate.EulerAnglesToAxesZXY(local->realAngle);
-
-						AddItem(Item(a_base, count, a_extra,
-							art_addon::ArtAddon::Make(
-								model, RE::PlayerCharacter::GetSingleton(), GetRoot(), temp)));
-					}
+					return AddItem(Item(a_base, count, a_extra,
+						art_addon::ArtAddon::Make(
+							model, RE::PlayerCharacter::GetSingleton(), GetRoot(), *local)));
 				}
 			}
 		}
@@ -1072,19 +1771,16 @@ namespace backpack
 	{
 		if (CanAcceptObject(a_base))
 		{
-			if (auto model = helper::GetObjectModelPath(a_base); model)
+			if (auto model = FormInfoCache::GetSingleton()->Get(a_base).model; model)
 			{
-				RE::NiTransform temp;
-				if (a_extra)
+				if (GetStoredTransform(a_base, a_extra))
 				{
-					if (auto local = a_extra->GetByType<RE::ExtraEditorRefMoveData>())
-					{
-						temp.rotate.EulerAnglesToAxesZXY(helper::deg2rad(-90), 0, 0);
+					RE::NiTransform temp;
+					temp.rotate.EulerAnglesToAxesZXY(helper::deg2rad(-90), 0, 0);
 
-						AddItem(Item(a_base, count, a_extra,
-							art_addon::ArtAddon::Make(
-								model, RE::PlayerCharacter::GetSingleton(), GetRoot(), temp)));
-					}
+					return AddItem(Item(a_base, count, a_extra,
+						art_addon::ArtAddon::Make(
+							model, RE::PlayerCharacter::GetSingleton(), GetRoot(), temp)));
 				}
 			}
 		}
@@ -1093,13 +1789,122 @@ namespace backpack
 
 	bool GridView::AddItemEx(RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra, int count)
 	{
+		if (!CanAcceptObject(a_base)) { return false; }
+		if (GetStoredTransform(a_base, a_extra)) { return false; }
+
+		// Items without extra data stack into one grid slot
+		if (auto refs = !a_extra && index ? index->Find(a_base->GetFormID()) : nullptr)
+		{
+			for (auto& ref : *refs)
+			{
+				if (ref.view == this && !ref.extra)
+				{
+					if (auto item = GetItem(ref.handle))
+					{
+						item->count += count;
+						return true;
+					}
+				}
+			}
+		}
+
+		// the grid is packed, so it's full once the first free slot is past the last row
+		if (occupied.FirstFree() >= GetCapacity())
+		{
+			return overflow && overflow->AddUnplacedItem(a_base, a_extra, count);
+		}
+
+		if (auto model = FormInfoCache::GetSingleton()->Get(a_base).model; model)
+		{
+			RE::NiTransform temp;
+			temp.translate = FindNextAvailableSlot(a_base);
+
+			return AddItem(Item(a_base, count, a_extra,
+				art_addon::ArtAddon::Make(
+					model, RE::PlayerCharacter::GetSingleton(), GetRoot(), temp)));
+		}
 		return false;
 	}
 
+	bool GridView::AddItem(const Item& a_item)
+	{
+		if (occupied.FirstFree() >= GetCapacity()) { return false; }
+
+		auto slot = occupied.Acquire();
+		if (slot == helper::SlotBitmap::kNone || !View::AddItem(a_item))
+		{
+			if (slot != helper::SlotBitmap::kNone) { occupied.Release(slot); }
+			return false;
+		}
+
+		auto& item = items.back();
+		if (slot >= slot_items.size()) { slot_items.resize(slot + 1, 0); }
+		slot_items[slot] = item.handle;
+		grid_slots[item.handle] = slot;
+		PlaceItem(item, slot);
+		return true;
+	}
+
+	void GridView::Remove(uint32_t a_handle)
+	{
+		if (auto it = grid_slots.find(a_handle); it != grid_slots.end())
+		{
+			auto hole = it->second;
+			grid_slots.erase(it);
+			slot_items[hole] = 0;
+			occupied.Release(hole);
+
+			auto last = occupied.LastUsed();
+			if (last != helper::SlotBitmap::kNone && last > hole)
+			{
+				auto moved = slot_items[last];
+				occupied.Release(last);
+				occupied.Set(hole);
+				slot_items[last] = 0;
+				slot_items[hole] = moved;
+				grid_slots[moved] = hole;
+
+				if (auto item = GetItem(moved)) { PlaceItem(*item, hole); }
+			}
+		}
+		View::Remove(a_handle);
+	}
+
+	RE::NiPoint3 GridView::GetSlotPosition(uint32_t a_slot) const
+	{
+		if (a_slot == helper::SlotBitmap::kNone) { return RE::NiPoint3::Zero(); }
+
+		auto& ml = mini_layout;
+		auto  per_row = std::max(1, Controller::GetSingleton()->GetSettings().mini_items_per_row);
+		auto  row = a_slot / per_row;
+		auto  column = a_slot % per_row;
+
+		return { max_bound.x * 0.5f, (column + 0.5f) * ml.width / per_row,
+			ml.height - (row + 0.5f) * (2 * ml.item_desired_radius + ml.vertical_spacing) };
+	}
+
+	uint32_t GridView::GetCapacity() const
+	{
+		auto per_row = std::max(1, Controller::GetSingleton()->GetSettings().mini_items_per_row);
+		return std::min(helper::SlotBitmap::kSlots,
+			(uint32_t)per_row * (uint32_t)mini_layout.items_per_column);
+	}
+
+	void GridView::PlaceItem(Item& a_item, uint32_t a_slot)
+	{
+		if (!a_item.model) { return; }
+
+		RE::NiTransform temp;
+		temp.translate = GetSlotPosition(a_slot);
+		a_item.model->SetLocal(temp);
+		NotifyItemMoved();
+	}
+
 	void GridView::CalculateGridLayout()
 	{
 		auto& settings = Controller::GetSingleton()->GetSettings();
 		auto& ml = mini_layout;
+		auto  old = ml;
 
 		if (root)
 		{
@@ -1113,18 +1918,63 @@ namespace backpack
 		ml.item_desired_radius =
 			(ml.width / settings.mini_items_per_row - settings.mini_horizontal_spacing) * 0.5;
 
-		ml.items_per_column =
-			std::floor(ml.height / (2 * ml.item_desired_radius + settings.mini_horizontal_spacing));
+		ml.items_per_column = std::max(1.f,
+			std::floor(ml.height / (2 * ml.item_desired_radius + settings.mini_horizontal_spacing)));
 
 		ml.vertical_spacing =
 			(ml.height - ml.items_per_column * 2 * ml.item_desired_radius) / ml.items_per_column;
+
+		if (old.width != ml.width || old.height != ml.height ||
+			old.item_desired_radius != ml.item_desired_radius ||
+			old.vertical_spacing != ml.vertical_spacing)
+		{
+			for (uint32_t slot = 0; slot < slot_items.size(); slot++)
+			{
+				if (auto item = slot_items[slot] ? GetItem(slot_items[slot]) : nullptr)
+				{
+					PlaceItem(*item, slot);
+				}
+			}
+		}
 	}
 
-	bool GridView::CanAcceptObject(RE::TESBoundObject* a_obj) { return false; }
+	RE::NiPoint3 NormalView::FindNextAvailableSlot(RE::TESBoundObject* a_inventory_item)
+	{
+		UpdateItemBounds();
 
-	bool Holster::CanAcceptObject(RE::TESBoundObject* a_obj) { return true; }
+		RE::NiPoint3 anchor = { (min_bound.x + max_bound.x) * 0.5f,
+			(min_bound.y + max_bound.y) * 0.5f, min_bound.z };
 
-	bool NormalView::CanAcceptObject(RE::TESBoundObject* a_obj) { return true; }
+		auto radius =
+			a_inventory_item ? FormInfoCache::GetSingleton()->Get(a_inventory_item).bound_radius : 0;
+		return occupancy.FindFree(anchor, radius).value_or(anchor);
+	}
+
+	bool NormalView::AddUnplacedItem(
+		RE::TESBoundObject* a_base, RE::ExtraDataList* a_extra, int count)
+	{
+		if (!CanAcceptObject(a_base)) { return false; }
+
+		if (auto model = FormInfoCache::GetSingleton()->Get(a_base).model; model)
+		{
+			RE::NiTransform temp;
+			temp.translate = FindNextAvailableSlot(a_base);
+
+			return AddItem(Item(a_base, count, a_extra,
+				art_addon::ArtAddon::Make(
+					model, RE::PlayerCharacter::GetSingleton(), GetRoot(), temp)));
+		}
+		return false;
+	}
+
+	bool GridView::Accepts(RE::TESBoundObject* a_obj)
+	{
+		return !Controller::GetSingleton()->GetSettings().disable_grid;
+	}
+
+	bool Holster::Accepts(RE::TESBoundObject* a_obj) { return true; }
+
+	bool NormalView::Accepts(RE::TESBoundObject* a_obj) { return true; }
 
 	void Backpack::MoveGrabbed()
 	{
@@ -1235,26 +2085,32 @@ namespace backpack
 	/* Extradata helper functions */
 	uint16_t SetOrGetID(RE::TESObjectREFR* a_obj)
 	{
+		auto& ids = Controller::GetSingleton()->GetItemIDs();
 		if (auto existing_ID = a_obj->extraList.GetByType<RE::ExtraUniqueID>())
 		{
+			// One of our IDs that expired, e.g. the item was stashed but never arrived
+			if (ids.Owns(existing_ID->uniqueID) && !ids.IsLive(existing_ID->uniqueID))
+			{
+				existing_ID->uniqueID = ids.Allocate();
+			}
 			return existing_ID->uniqueID;
 		}
 		else
 		{
+			auto ID = ids.Allocate();
+			if (!ID)
+			{
+				SKSE::log::error("out of item IDs, {} pending", ids.InUse());
+				return 0;
+			}
+
 			auto temp = new RE::ExtraUniqueID();
-			temp->uniqueID = g_ID_upper;
+			temp->uniqueID = ID;
 			a_obj->extraList.Add(temp);
-			return g_ID_upper;
+			return ID;
 		}
 	}
 
-	void AddTransformData(RE::ExtraDataList* a_edl, RE::NiTransform& a_transform)
-	{
-		auto temp = new RE::ExtraEditorRefMoveData();
-		temp->realLocation = a_transform.translate;
-		a_transform.rotate.ToEulerAnglesXYZ(temp->realAngle);
-		a_edl->Add(temp);
-	}
 }
 
 namespace RE
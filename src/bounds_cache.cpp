@@ -0,0 +1,149 @@
+#include "bounds_cache.h"
+
+#include "helper_game.h"
+
+#include <fstream>
+
+namespace backpack
+{
+	namespace
+	{
+		template <typename T>
+		bool ReadValue(std::ifstream& a_file, T& a_out)
+		{
+			return (bool)a_file.read(reinterpret_cast<char*>(&a_out), sizeof(T));
+		}
+
+		template <typename T>
+		void WriteValue(std::ofstream& a_file, const T& a_value)
+		{
+			a_file.write(reinterpret_cast<const char*>(&a_value), sizeof(T));
+		}
+	}
+
+	void ModelBoundsCache::Load()
+	{
+		entries.clear();
+		baked_bounds.clear();
+		dirty = false;
+
+		if (std::ifstream index(helper::GetGamePath() / kIndexPath, std::ios::binary);
+			index.is_open())
+		{
+			index.seekg(0, std::ios::end);
+			baked_data.resize((std::size_t)index.tellg());
+			index.seekg(0);
+			index.read(reinterpret_cast<char*>(baked_data.data()), baked_data.size());
+			if (!baked.Attach(baked_data)) { SKSE::log::error("nif index: ignoring invalid file"); }
+			SKSE::log::trace("nif index: {} models", baked.GetModels().size());
+		}
+
+		std::ifstream file(helper::GetGamePath() / kFilePath, std::ios::binary);
+		if (!file.is_open()) { return; }
+
+		uint32_t magic = 0, version = 0, count = 0;
+		if (!ReadValue(file, magic) || !ReadValue(file, version) || !ReadValue(file, count) ||
+			magic != kMagic || version != kVersion)
+		{
+			SKSE::log::error("model bounds cache: ignoring invalid file");
+			return;
+		}
+
+		for (uint32_t i = 0; i < count; i++)
+		{
+			uint16_t    length = 0;
+			std::string path;
+			Entry       entry;
+			if (!ReadValue(file, length)) { break; }
+
+			path.resize(length);
+			if (!file.read(path.data(), length) || !ReadValue(file, entry.timestamp) ||
+				!ReadValue(file, entry.bounds))
+			{
+				SKSE::log::error("model bounds cache: file is truncated");
+				break;
+			}
+			entries.insert_or_assign(std::move(path), entry);
+		}
+		SKSE::log::trace("model bounds cache: {} models loaded", entries.size());
+	}
+
+	void ModelBoundsCache::Save()
+	{
+		if (!dirty) { return; }
+
+		std::ofstream file(helper::GetGamePath() / kFilePath, std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+		{
+			SKSE::log::error("model bounds cache: can't write {}", kFilePath);
+			return;
+		}
+
+		WriteValue(file, kMagic);
+		WriteValue(file, kVersion);
+		WriteValue(file, (uint32_t)entries.size());
+		for (auto& [path, entry] : entries)
+		{
+			WriteValue(file, (uint16_t)path.size());
+			file.write(path.data(), path.size());
+			WriteValue(file, entry.timestamp);
+			WriteValue(file, entry.bounds);
+		}
+		dirty = false;
+		SKSE::log::trace("model bounds cache: {} models saved", entries.size());
+	}
+
+	const ModelBounds* ModelBoundsCache::Find(std::string_view a_model)
+	{
+		auto it = entries.find(a_model);
+		if (it == entries.end())
+		{
+			if (auto baked_it = baked_bounds.find(a_model); baked_it != baked_bounds.end())
+			{
+				return &baked_it->second;
+			}
+
+			auto record = baked.Find(a_model);
+			if (!record || record->radius <= 0) { return nullptr; }
+
+			// the index is rebaked when the meshes change, so no timestamp to check
+			ModelBounds bounds;
+			bounds.center = { record->center[0], record->center[1], record->center[2] };
+			bounds.radius = record->radius;
+			bounds.extents = { record->extents[0], record->extents[1], record->extents[2] };
+			return &baked_bounds.emplace(a_model, bounds).first->second;
+		}
+
+		auto& entry = it->second;
+		if (!entry.checked)
+		{
+			if (entry.timestamp != GetModelTimestamp(a_model))
+			{
+				entries.erase(it);
+				dirty = true;
+				return nullptr;
+			}
+			entry.checked = true;
+		}
+		return &entry.bounds;
+	}
+
+	void ModelBoundsCache::Record(std::string_view a_model, const ModelBounds& a_bounds)
+	{
+		if (a_model.empty() || a_model.size() > UINT16_MAX || a_bounds.radius <= 0) { return; }
+
+		auto& entry = entries[std::string(a_model)];
+		entry.bounds = a_bounds;
+		entry.timestamp = GetModelTimestamp(a_model);
+		entry.checked = true;
+		dirty = true;
+	}
+
+	int64_t ModelBoundsCache::GetModelTimestamp(std::string_view a_model)
+	{
+		std::error_code error;
+		auto time = std::filesystem::last_write_time(
+			helper::GetGamePath() / "meshes" / a_model, error);
+		return error ? 0 : time.time_since_epoch().count();
+	}
+}
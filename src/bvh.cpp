@@ -0,0 +1,138 @@
+#include "bvh.h"
+
+#include <algorithm>
+#include <cfloat>
+
+namespace bvh
+{
+	using namespace RE;
+
+	constexpr int kMaxDepth = 32;
+
+	void SphereTree::Build(const std::vector<Sphere>& a_spheres)
+	{
+		Clear();
+
+		std::vector<uint32_t> order;
+		for (uint32_t i = 0; i < a_spheres.size(); i++)
+		{
+			if (a_spheres[i].radius > 0) { order.push_back(i); }
+		}
+		if (order.empty()) { return; }
+
+		nodes.reserve(2 * BlockCount((uint32_t)order.size()));
+		blocks.reserve(2 * BlockCount((uint32_t)order.size()));
+		BuildRecursive(a_spheres, order, 0, (uint32_t)order.size(), 0);
+	}
+
+	uint32_t SphereTree::BuildRecursive(const std::vector<Sphere>& a_spheres,
+		std::vector<uint32_t>& a_order, uint32_t a_begin, uint32_t a_end, int a_depth)
+	{
+		auto index = (uint32_t)nodes.size();
+		nodes.emplace_back();
+
+		if (a_end - a_begin <= SphereBlock::kWidth || a_depth >= kMaxDepth)
+		{  // pack the spheres into blocks, padding the last one with lanes that never overlap
+			nodes[index].first = (uint32_t)blocks.size();
+			nodes[index].count = a_end - a_begin;
+
+			for (uint32_t i = a_begin; i < a_end; i += SphereBlock::kWidth)
+			{
+				auto& block = blocks.emplace_back();
+				for (uint32_t lane = 0; lane < SphereBlock::kWidth; lane++)
+				{
+					block.index[lane] = i + lane < a_end ? a_order[i + lane] : 0;
+				}
+			}
+			FitLeaf(nodes[index], a_spheres);
+			return index;
+		}
+
+		// split at the median of the longest axis of the box around the centers
+		NiPoint3 cmin = a_spheres[a_order[a_begin]].center;
+		NiPoint3 cmax = cmin;
+		for (uint32_t i = a_begin + 1; i < a_end; i++)
+		{
+			auto& c = a_spheres[a_order[i]].center;
+			cmin = { std::min(cmin.x, c.x), std::min(cmin.y, c.y), std::min(cmin.z, c.z) };
+			cmax = { std::max(cmax.x, c.x), std::max(cmax.y, c.y), std::max(cmax.z, c.z) };
+		}
+		auto extent = cmax - cmin;
+		int  axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) :
+										  (extent.y > extent.z ? 1 : 2);
+
+		auto mid = a_begin + (a_end - a_begin) / 2;
+		std::nth_element(a_order.begin() + a_begin, a_order.begin() + mid,
+			a_order.begin() + a_end, [&a_spheres, axis](uint32_t a, uint32_t b) {
+				return a_spheres[a].center[axis] < a_spheres[b].center[axis];
+			});
+
+		BuildRecursive(a_spheres, a_order, a_begin, mid, a_depth + 1);
+		auto right = BuildRecursive(a_spheres, a_order, mid, a_end, a_depth + 1);
+
+		auto& node = nodes[index];
+		auto& l = nodes[index + 1];
+		auto& r = nodes[right];
+		node.first = right;
+		node.count = 0;
+		node.min = { std::min(l.min.x, r.min.x), std::min(l.min.y, r.min.y),
+			std::min(l.min.z, r.min.z) };
+		node.max = { std::max(l.max.x, r.max.x), std::max(l.max.y, r.max.y),
+			std::max(l.max.z, r.max.z) };
+
+		return index;
+	}
+
+	void SphereTree::FitLeaf(Node& a_node, const std::vector<Sphere>& a_spheres)
+	{
+		a_node.min = { FLT_MAX, FLT_MAX, FLT_MAX };
+		a_node.max = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+
+		for (uint32_t i = 0; i < a_node.count; i++)
+		{
+			auto& block = blocks[a_node.first + i / SphereBlock::kWidth];
+			auto  lane = i % SphereBlock::kWidth;
+			auto& s = a_spheres[block.index[lane]];
+
+			block.x[lane] = s.center.x;
+			block.y[lane] = s.center.y;
+			block.z[lane] = s.center.z;
+			block.radius_sq[lane] = s.radius * s.radius;
+
+			a_node.min = { std::min(a_node.min.x, s.center.x - s.radius),
+				std::min(a_node.min.y, s.center.y - s.radius),
+				std::min(a_node.min.z, s.center.z - s.radius) };
+			a_node.max = { std::max(a_node.max.x, s.center.x + s.radius),
+				std::max(a_node.max.y, s.center.y + s.radius),
+				std::max(a_node.max.z, s.center.z + s.radius) };
+		}
+
+		// unused lanes of the last block
+		for (auto i = a_node.count; i % SphereBlock::kWidth; i++)
+		{
+			auto& block = blocks[a_node.first + i / SphereBlock::kWidth];
+			auto  lane = i % SphereBlock::kWidth;
+			block.x[lane] = block.y[lane] = block.z[lane] = 0;
+			block.radius_sq[lane] = -1;
+		}
+	}
+
+	void SphereTree::Refit(const std::vector<Sphere>& a_spheres)
+	{
+		// children are always stored after their parent, so walking backwards is bottom-up
+		for (auto i = nodes.size(); i-- > 0;)
+		{
+			auto& node = nodes[i];
+			if (node.count) { FitLeaf(node, a_spheres); }
+			else
+			{
+				auto& l = nodes[i + 1];
+				auto& r = nodes[node.first];
+				node.min = { std::min(l.min.x, r.min.x), std::min(l.min.y, r.min.y),
+					std::min(l.min.z, r.min.z) };
+				node.max = { std::max(l.max.x, r.max.x), std::max(l.max.y, r.max.y),
+					std::max(l.max.z, r.max.z) };
+			}
+		}
+	}
+}
@@ -0,0 +1,26 @@
+#include "form_info.h"
+
+#include "backpack.h"
+#include "bounds_cache.h"
+#include "helper_game.h"
+
+namespace backpack
+{
+	FormInfo FormInfoCache::Resolve(RE::TESBoundObject* a_obj)
+	{
+		FormInfo info;
+		info.model = helper::GetObjectModelPath(a_obj);
+		info.bound_radius = helper::GetBoundRadius(a_obj);
+
+		// the model's own bound is more accurate than the form's, if it has been measured
+		if (auto bounds = info.model ? ModelBoundsCache::GetSingleton()->Find(info.model) : nullptr)
+		{
+			info.bound_radius = bounds->radius;
+		}
+
+		if (NormalView::Accepts(a_obj)) { info.view_mask |= View::Type::kNormal; }
+		if (GridView::Accepts(a_obj)) { info.view_mask |= View::Type::kGrid; }
+		if (Holster::Accepts(a_obj)) { info.view_mask |= View::Type::kHolster; }
+		return info;
+	}
+}
@@ -339,6 +339,12 @@ namespace helper
 		return nullptr;
 	}
 
+	float GetBoundRadius(RE::TESBoundObject* a_obj)
+	{
+		auto& bounds = a_obj->boundData;
+		return (bounds.boundMax - bounds.boundMin).Length() * 0.5f;
+	}
+
 	const char* GetObjectModelPath(RE::TESObjectREFR* a_obj)
 	{
 		if (auto boundobj = a_obj->GetBaseObject())
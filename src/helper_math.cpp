@@ -362,6 +362,78 @@ namespace helper
 		matrix.entry[2][2] = 1 - 2 * (xx + yy);
 	}
 
+	NiQuaternion Mat2Quat(const NiMatrix3& a_matrix)
+	{
+		auto&        m = a_matrix.entry;
+		NiQuaternion q;
+
+		// Build from the largest of w x y z, dividing by a small one loses precision
+		auto trace = m[0][0] + m[1][1] + m[2][2];
+		if (trace > 0)
+		{
+			auto s = 0.5f / sqrtf(trace + 1.f);
+			q.w = 0.25f / s;
+			q.x = (m[2][1] - m[1][2]) * s;
+			q.y = (m[0][2] - m[2][0]) * s;
+			q.z = (m[1][0] - m[0][1]) * s;
+		}
+		else if (m[0][0] > m[1][1] && m[0][0] > m[2][2])
+		{
+			auto s = 2.f * sqrtf(1.f + m[0][0] - m[1][1] - m[2][2]);
+			q.w = (m[2][1] - m[1][2]) / s;
+			q.x = 0.25f * s;
+			q.y = (m[0][1] + m[1][0]) / s;
+			q.z = (m[0][2] + m[2][0]) / s;
+		}
+		else if (m[1][1] > m[2][2])
+		{
+			auto s = 2.f * sqrtf(1.f + m[1][1] - m[0][0] - m[2][2]);
+			q.w = (m[0][2] - m[2][0]) / s;
+			q.x = (m[0][1] + m[1][0]) / s;
+			q.y = 0.25f * s;
+			q.z = (m[1][2] + m[2][1]) / s;
+		}
+		else
+		{
+			auto s = 2.f * sqrtf(1.f + m[2][2] - m[0][0] - m[1][1]);
+			q.w = (m[1][0] - m[0][1]) / s;
+			q.x = (m[0][2] + m[2][0]) / s;
+			q.y = (m[1][2] + m[2][1]) / s;
+			q.z = 0.25f * s;
+		}
+
+		auto length = sqrtf(q.w * q.w + q.x * q.x + q.y * q.y + q.z * q.z);
+		q.w /= length;
+		q.x /= length;
+		q.y /= length;
+		q.z /= length;
+		return q;
+	}
+
+	CompactPose PackPose(const NiTransform& a_transform, const NiPoint3& a_range)
+	{
+		auto q = Mat2Quat(a_transform.rotate);
+		return CompactPose::Encode(
+			{ a_transform.translate.x, a_transform.translate.y, a_transform.translate.z },
+			{ q.x, q.y, q.z, q.w }, { a_range.x, a_range.y, a_range.z });
+	}
+
+	NiTransform UnpackPose(const CompactPose& a_pose, const NiPoint3& a_range)
+	{
+		auto position = a_pose.DecodePosition({ a_range.x, a_range.y, a_range.z });
+		auto rotation = a_pose.DecodeRotation();
+
+		NiTransform  result;
+		NiQuaternion q;
+		q.x = rotation[0];
+		q.y = rotation[1];
+		q.z = rotation[2];
+		q.w = rotation[3];
+		Quat2Mat(result.rotate, q);
+		result.translate = { position[0], position[1], position[2] };
+		return result;
+	}
+
 	void slerpQuat(float interp, NiQuaternion& q1, NiQuaternion& q2, NiMatrix3& out)
 	{
 		float q1w = q1.w;
@@ -0,0 +1,94 @@
+#include "inventory_mirror.h"
+
+namespace backpack
+{
+	using namespace RE;
+
+	void InventoryMirror::Seed(TESObjectREFR* a_owner)
+	{
+		Clear();
+		if (!a_owner) { return; }
+
+		for (auto& [obj, data] : a_owner->GetInventory())
+		{
+			entries[obj].count = data.first;
+		}
+
+		// GetInventory returns copies of the entries, we want the live ones
+		if (auto changes = a_owner->GetInventoryChanges(); changes && changes->entryList)
+		{
+			for (auto entry : *changes->entryList)
+			{
+				if (entry && entry->object)
+				{
+					if (auto it = entries.find(entry->object); it != entries.end())
+					{
+						it->second.changes = entry;
+					}
+				}
+			}
+		}
+		seeded = true;
+	}
+
+	void InventoryMirror::Apply(TESObjectREFR* a_owner, TESBoundObject* a_obj, int a_delta)
+	{
+		if (!seeded || !a_obj) { return; }
+
+		auto& entry = entries[a_obj];
+		entry.count += a_delta;
+
+		// The game frees an InventoryEntryData whose changes net back to zero, even while the
+		// base container still has the item, so the cached pointer can't be trusted here
+		if (entry.count <= 0) { entries.erase(a_obj); }
+		else { entry.changes = FindChanges(a_owner, a_obj); }
+	}
+
+	InventoryEntryData* InventoryMirror::FindChanges(TESObjectREFR* a_owner, TESBoundObject* a_obj)
+	{
+		if (auto changes = a_owner->GetInventoryChanges(); changes && changes->entryList)
+		{
+			for (auto entry : *changes->entryList)
+			{
+				if (entry && entry->object == a_obj) { return entry; }
+			}
+		}
+		return nullptr;
+	}
+
+	bool InventoryMirror::DebugCheck(TESObjectREFR* a_owner) const
+	{
+		bool match = true;
+		auto inv = a_owner->GetInventory();
+
+		for (auto& [obj, data] : inv)
+		{
+			auto mirrored = Find(obj);
+			if (!mirrored || mirrored->count != data.first)
+			{
+				SKSE::log::error("inventory mirror: {} count {} but game has {}", obj->GetName(),
+					mirrored ? mirrored->count : 0, data.first);
+				match = false;
+			}
+		}
+		for (auto& [obj, entry] : entries)
+		{
+			if (!inv.contains(obj))
+			{
+				SKSE::log::error("inventory mirror: {} count {} but game has none", obj->GetName(),
+					entry.count);
+				match = false;
+			}
+			else if (entry.changes != FindChanges(a_owner, obj))
+			{
+				SKSE::log::error(
+					"inventory mirror: {} has a stale InventoryEntryData", obj->GetName());
+				match = false;
+			}
+		}
+
+		SKSE::log::trace("inventory mirror check {}: {} entries", match ? "passed" : "FAILED",
+			entries.size());
+		return match;
+	}
+}
@@ -0,0 +1,160 @@
+#include "layout_table.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+#include <vector>
+
+namespace backpack
+{
+	using namespace RE;
+
+	uint16_t LayoutTable::GetStackKey(ExtraDataList* a_extra)
+	{
+		auto uid = a_extra ? a_extra->GetByType<ExtraUniqueID>() : nullptr;
+		return uid && !helper::IDAllocator::Owns(uid->uniqueID) ? uid->uniqueID : 0;
+	}
+
+	std::optional<helper::CompactPose> LayoutTable::Find(
+		const TESBoundObject* a_base, ExtraDataList* a_extra) const
+	{
+		if (auto key = GetStackKey(a_extra))
+		{
+			if (auto it = entries.find(MakeKey(a_base->GetFormID(), key)); it != entries.end())
+			{
+				return it->second;
+			}
+		}
+		return std::nullopt;
+	}
+
+	void LayoutTable::Record(
+		const TESBoundObject* a_base, ExtraDataList* a_extra, const helper::CompactPose& a_pose)
+	{
+		if (!a_extra) { return; }
+
+		auto key = GetStackKey(a_extra);
+		if (!key)
+		{
+			if (key = NewKey(); !key)
+			{
+				SKSE::log::error("layout: out of keys, {} stacks placed", entries.size());
+				return;
+			}
+			// GetStackKey returned 0, so an ID already on the stack is one of our transient ones
+			if (auto uid = a_extra->GetByType<ExtraUniqueID>()) { uid->uniqueID = key; }
+			else
+			{
+				auto temp = new ExtraUniqueID();
+				temp->uniqueID = key;
+				a_extra->Add(temp);
+			}
+		}
+		entries.insert_or_assign(MakeKey(a_base->GetFormID(), key), a_pose);
+	}
+
+	uint16_t LayoutTable::NewKey()
+	{
+		// keys are handed out in order, so one is only reused after all the others
+		for (uint32_t tries = 0; tries < kKeyMask; tries++)
+		{
+			next_key = next_key % kKeyMask + 1;
+			uint16_t key = kKeyTag | next_key;
+			if (std::none_of(entries.begin(), entries.end(),
+					[key](const auto& e) { return (uint16_t)e.first == key; }))
+			{
+				return key;
+			}
+		}
+		return 0;
+	}
+
+	void LayoutTable::Prune(TESObjectREFR* a_wearer)
+	{
+		auto changes = a_wearer ? a_wearer->GetInventoryChanges() : nullptr;
+		if (!changes || !changes->entryList) { return; }
+
+		std::unordered_set<uint64_t> live;
+		for (auto entry : *changes->entryList)
+		{
+			if (!entry || !entry->object || !entry->extraLists) { continue; }
+			for (auto extra : *entry->extraLists)
+			{
+				if (auto key = GetStackKey(extra))
+				{
+					live.insert(MakeKey(entry->object->GetFormID(), key));
+				}
+			}
+		}
+		std::erase_if(entries, [&live](const auto& e) { return !live.contains(e.first); });
+	}
+
+	bool LayoutTable::Save(SKSE::SerializationInterface* a_intfc, FormID a_wearer) const
+	{
+		auto              count = (uint32_t)entries.size();
+		std::vector<char> packed(count * kEntrySize);
+		auto              out = packed.data();
+		for (auto& [key, pose] : entries)
+		{
+			auto     base = (FormID)(key >> 16);
+			uint16_t id = (uint16_t)key;
+			std::memcpy(out, &base, sizeof(base));
+			std::memcpy(out + 4, &id, sizeof(id));
+			std::memcpy(out + 6, pose.position, sizeof(pose.position));
+			std::memcpy(out + 12, pose.rotation, sizeof(pose.rotation));
+			out += kEntrySize;
+		}
+
+		return a_intfc->WriteRecordData(a_wearer) && a_intfc->WriteRecordData(next_key) &&
+			a_intfc->WriteRecordData(count) &&
+			a_intfc->WriteRecordData(packed.data(), (uint32_t)packed.size());
+	}
+
+	FormID LayoutTable::ReadWearer(SKSE::SerializationInterface* a_intfc)
+	{
+		FormID wearer = 0;
+		if (!a_intfc->ReadRecordData(wearer) || !a_intfc->ResolveFormID(wearer, wearer))
+		{
+			return 0;
+		}
+		return wearer;
+	}
+
+	bool LayoutTable::Load(SKSE::SerializationInterface* a_intfc, uint32_t a_length)
+	{
+		Clear();
+
+		uint32_t count = 0;
+		if (!a_intfc->ReadRecordData(next_key) || !a_intfc->ReadRecordData(count)) { return false; }
+
+		// a corrupt or foreign record must not make us allocate whatever it claims
+		constexpr uint32_t kHeaderSize = sizeof(next_key) + sizeof(count);
+		if (a_length < kHeaderSize || count > (a_length - kHeaderSize) / kEntrySize)
+		{
+			SKSE::log::error("layout: record holds {} bytes but claims {} entries", a_length,
+				count);
+			return false;
+		}
+
+		std::vector<char> packed(count * kEntrySize);
+		auto              size = (uint32_t)packed.size();
+		if (a_intfc->ReadRecordData(packed.data(), size) != size) { return false; }
+
+		// base forms can move when the load order changes, drop the ones that are gone
+		for (auto in = packed.data(); in != packed.data() + size; in += kEntrySize)
+		{
+			FormID              base;
+			uint16_t            key;
+			helper::CompactPose pose;
+			std::memcpy(&base, in, sizeof(base));
+			std::memcpy(&key, in + 4, sizeof(key));
+			std::memcpy(pose.position, in + 6, sizeof(pose.position));
+			std::memcpy(pose.rotation, in + 12, sizeof(pose.rotation));
+			if (a_intfc->ResolveFormID(base, base))
+			{
+				entries.insert_or_assign(MakeKey(base, key), pose);
+			}
+		}
+		return true;
+	}
+}
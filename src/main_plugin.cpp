@@ -98,6 +98,14 @@ namespace backpackvr
 
 		hooks::Install();
 
+		backpack::ModelBoundsCache::GetSingleton()->Load();
+
+		// Create the art forms for our own effect models now, so the first summon doesn't have to
+		for (auto model : { "HelperSphere.nif", art_addon::NifChar::kFontModelPath })
+		{
+			art_addon::ArtAddonManager::GetSingleton()->Preload(model);
+		}
+
 		auto containerSink = EventSink<TESContainerChangedEvent>::GetSingleton();
 		ScriptEventSourceHolder::GetSingleton()->AddEventSink(containerSink);
 		containerSink->AddCallback(OnContainerChanged);
@@ -255,6 +263,26 @@ namespace backpackvr
 						helper::ReadFloatFromIni(config, "fPlayerShutoffDistance");
 					settings.shutoff_distance_player =
 						helper::ReadFloatFromIni(config, "fNPCShutoffDistance");
+					if (auto budget = helper::ReadIntFromIni(config, "iLoadBudgetMicroseconds");
+						budget > 0)
+					{
+						settings.load_budget_us = budget;
+					}
+					if (auto dist = helper::ReadFloatFromIni(config, "fLODFullDistance"); dist > 0)
+					{
+						settings.lod_full_distance = dist;
+					}
+					if (auto dist = helper::ReadFloatFromIni(config, "fLODProxyDistance"); dist > 0)
+					{
+						settings.lod_proxy_distance = dist;
+					}
+					if (auto dist = helper::ReadFloatFromIni(config, "fInteractionHysteresis");
+						dist > 0)
+					{
+						settings.interaction_hysteresis = dist;
+					}
+					// View acceptance depends on the settings
+					backpack::FormInfoCache::GetSingleton()->Clear();
 
 					config.close();
 					last_read = last_write_time(config_path);
@@ -312,6 +340,12 @@ namespace backpackvr
 					else { SKSE::log::trace("  no extralist for {}", name); }
 				}
 			}
+
+			if (auto bp = backpack::Controller::GetSingleton()->GetBackpackByWearer(
+					backpack::kPlayerForm))
+			{
+				bp->DebugCheckInventory();
+			}
 		}
 		return false;
 	}
@@ -0,0 +1,154 @@
+#include "occupancy_grid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace helper
+{
+	using namespace RE;
+
+	void OccupancyGrid::Reset(const NiPoint3& a_min, const NiPoint3& a_max)
+	{
+		auto size = a_max - a_min;
+		cell = std::max({ size.x, size.y, size.z, 1.f }) / kMaxCells;
+		origin = a_min;
+		dims[0] = std::clamp((int)std::ceil(size.x / cell), 1, kMaxCells);
+		dims[1] = std::clamp((int)std::ceil(size.y / cell), 1, kMaxCells);
+		dims[2] = std::clamp((int)std::ceil(size.z / cell), 1, kMaxCells);
+
+		occupancy.assign(dims[0] * dims[1] * dims[2], 0);
+		clearance.assign(occupancy.size(), 0);
+		dirty = true;
+	}
+
+	void OccupancyGrid::Stamp(const bvh::Sphere& a_sphere, int a_delta)
+	{
+		if (a_sphere.radius <= 0 || occupancy.empty()) { return; }
+
+		auto local = (a_sphere.center - origin) / cell;
+		auto r = a_sphere.radius / cell;
+		auto r_sq = r * r;
+
+		// only the cells inside the sphere's box can overlap it
+		float c[3] = { local.x, local.y, local.z };
+		int   lo[3], hi[3];
+		for (int a = 0; a < 3; a++)
+		{
+			lo[a] = std::max(0, (int)std::floor(c[a] - r));
+			hi[a] = std::min(dims[a] - 1, (int)std::floor(c[a] + r));
+		}
+
+		for (int z = lo[2]; z <= hi[2]; z++)
+		{
+			for (int y = lo[1]; y <= hi[1]; y++)
+			{
+				for (int x = lo[0]; x <= hi[0]; x++)
+				{
+					// closest point of the cell to the sphere center
+					float dx = c[0] - std::clamp(c[0], (float)x, x + 1.f);
+					float dy = c[1] - std::clamp(c[1], (float)y, y + 1.f);
+					float dz = c[2] - std::clamp(c[2], (float)z, z + 1.f);
+					if (dx * dx + dy * dy + dz * dz < r_sq)
+					{
+						auto& count = occupancy[Index(x, y, z)];
+						count = (uint16_t)std::max(0, count + a_delta);
+					}
+				}
+			}
+		}
+		dirty = true;
+	}
+
+	void OccupancyGrid::UpdateClearance()
+	{
+		if (!dirty) { return; }
+		dirty = false;
+
+		// Occupied cells start half a cell below zero so their neighbours measure to the cell's
+		// face, free cells start at the distance to the nearest wall
+		for (int z = 0; z < dims[2]; z++)
+		{
+			for (int y = 0; y < dims[1]; y++)
+			{
+				for (int x = 0; x < dims[0]; x++)
+				{
+					auto i = Index(x, y, z);
+					auto wall =
+						std::min({ x, y, z, dims[0] - 1 - x, dims[1] - 1 - y, dims[2] - 1 - z });
+					clearance[i] = occupancy[i] ? -0.5f * cell : (wall + 0.5f) * cell;
+				}
+			}
+		}
+
+		const float w[4] = { 0, cell, cell * std::sqrt(2.f), cell * std::sqrt(3.f) };
+
+		auto relax = [&](int x, int y, int z, int dir) {
+			auto& d = clearance[Index(x, y, z)];
+			// the 13 neighbours that come before the cell in the pass direction
+			for (int dz = -1; dz <= 0; dz++)
+			{
+				for (int dy = -1; dy <= 1; dy++)
+				{
+					for (int dx = -1; dx <= 1; dx++)
+					{
+						if (dz == 0 && (dy > 0 || (dy == 0 && dx >= 0))) { continue; }
+
+						int nx = x + dx * dir, ny = y + dy * dir, nz = z + dz * dir;
+						if (nx < 0 || ny < 0 || nz < 0 || nx >= dims[0] || ny >= dims[1] ||
+							nz >= dims[2])
+						{
+							continue;
+						}
+						d = std::min(
+							d, clearance[Index(nx, ny, nz)] + w[dx * dx + dy * dy + dz * dz]);
+					}
+				}
+			}
+		};
+
+		for (int z = 0; z < dims[2]; z++)
+		{
+			for (int y = 0; y < dims[1]; y++)
+			{
+				for (int x = 0; x < dims[0]; x++) { relax(x, y, z, 1); }
+			}
+		}
+		for (int z = dims[2] - 1; z >= 0; z--)
+		{
+			for (int y = dims[1] - 1; y >= 0; y--)
+			{
+				for (int x = dims[0] - 1; x >= 0; x--) { relax(x, y, z, -1); }
+			}
+		}
+	}
+
+	std::optional<NiPoint3> OccupancyGrid::FindFree(const NiPoint3& a_anchor, float a_radius)
+	{
+		if (occupancy.empty()) { return std::nullopt; }
+
+		UpdateClearance();
+
+		std::optional<NiPoint3> best;
+		float                   best_dist_sq = std::numeric_limits<float>::max();
+		for (int z = 0; z < dims[2]; z++)
+		{
+			for (int y = 0; y < dims[1]; y++)
+			{
+				for (int x = 0; x < dims[0]; x++)
+				{
+					if (clearance[Index(x, y, z)] < a_radius) { continue; }
+
+					auto center = CellCenter(x, y, z);
+					auto dist_sq = center.GetSquaredDistance(a_anchor);
+					if (dist_sq < best_dist_sq)
+					{
+						best_dist_sq = dist_sq;
+						best = center;
+					}
+				}
+			}
+		}
+		return best;
+	}
+}
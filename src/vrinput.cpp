@@ -36,7 +36,7 @@ namespace vrinput
 	std::deque<std::pair<ModInputEvent, vr::EVRButtonId>> fake_event_queue_right;
 
 	vr::VRControllerAxis_t joystick[2] = {};
-	float                  trigger[2];
+	float                  trigger[2] = {};
 
 	// each button id is mapped to a list of callback funcs
 	std::unordered_map<int, std::vector<InputCallback>> callbacks;
@@ -60,6 +60,10 @@ namespace vrinput
 			bool)(button_states[(int)a_hand][(int)a_touch_or_press] & 1ull << a_button_ID));
 	}
 
+	const float GetTrigger(Hand a) { return trigger[a == Hand::kLeft]; }
+
+	const vr::VRControllerAxis_t& GetJoystick(Hand a) { return joystick[a == Hand::kLeft]; }
+
 	void AddCallback(const InputCallbackFunc a_callback, const vr::EVRButtonId a_button,
 		const Hand hand, const ActionType touch_or_press)
 	{
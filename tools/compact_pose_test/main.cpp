@@ -0,0 +1,305 @@
+/* Round-trip tests and benchmark for helper::CompactPose, see include/compact_pose.h.
+ *
+ * Usage: compact_pose_test          runs the tests, exit code 1 if any failed
+ *        compact_pose_test --bench  measures encode and decode throughput
+ */
+#include "compact_pose.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+	using helper::CompactPose;
+
+	// rotation steps are kComponentLimit / kComponentZero, about 4.3e-5 per component
+	constexpr double kMaxAngleError = 2e-4;
+
+	int failures = 0;
+
+	void Check(bool a_ok, const char* a_what)
+	{
+		if (!a_ok)
+		{
+			if (failures < 20) { std::printf("FAILED: %s\n", a_what); }
+			failures++;
+		}
+	}
+
+	CompactPose::Quaternion Normalized(CompactPose::Quaternion a_q)
+	{
+		double length = 0;
+		for (auto c : a_q) { length += (double)c * c; }
+		length = std::sqrt(length);
+		for (auto& c : a_q) { c = (float)(c / length); }
+		return a_q;
+	}
+
+	/* Returns: the angle between the rotations of two quaternions, in radians */
+	double AngleBetween(const CompactPose::Quaternion& a_q1, const CompactPose::Quaternion& a_q2)
+	{
+		double dot = 0, length1 = 0, length2 = 0;
+		for (int i = 0; i < 4; i++)
+		{
+			dot += (double)a_q1[i] * a_q2[i];
+			length1 += (double)a_q1[i] * a_q1[i];
+			length2 += (double)a_q2[i] * a_q2[i];
+		}
+		return 2 * std::acos(std::min(1.0, std::abs(dot) / std::sqrt(length1 * length2)));
+	}
+
+	/* Decoding a pose and encoding it again must give back the same bits */
+	bool ReEncodes(const CompactPose& a_pose, const CompactPose::Vector& a_range)
+	{
+		return CompactPose::Encode(a_pose.DecodePosition(a_range), a_pose.DecodeRotation(),
+				   a_range) == a_pose;
+	}
+
+	/* Encodes, checks the bits survive another round and the error stays in bounds */
+	void CheckPose(const CompactPose::Vector& a_position, const CompactPose::Quaternion& a_rotation,
+		const CompactPose::Vector& a_range, const char* a_what)
+	{
+		auto pose = CompactPose::Encode(a_position, a_rotation, a_range);
+		Check(ReEncodes(pose, a_range), a_what);
+		Check(AngleBetween(pose.DecodeRotation(), a_rotation) < kMaxAngleError, a_what);
+
+		auto position = pose.DecodePosition(a_range);
+		for (int i = 0; i < 3; i++)
+		{
+			auto expected = std::clamp(a_position[i], -a_range[i], a_range[i]);
+			auto step = a_range[i] / CompactPose::kPositionMax;
+			Check(std::abs(position[i] - expected) <= step * 0.5f + 1e-6f * a_range[i], a_what);
+		}
+	}
+
+	void TestIdentity()
+	{
+		CompactPose pose;
+		auto        q = pose.DecodeRotation();
+		Check(q[0] == 0 && q[1] == 0 && q[2] == 0 && q[3] == 1, "default pose is the identity");
+		Check(pose == CompactPose::Encode({}, { 0, 0, 0, 1 }, { 1, 1, 1 }),
+			"identity encodes to the default pose");
+		Check(pose == CompactPose::Encode({}, { 0, 0, 0, -1 }, { 1, 1, 1 }),
+			"-identity encodes to the default pose");
+	}
+
+	void TestRandom(std::mt19937& a_rng)
+	{
+		std::normal_distribution<float>       normal;
+		std::uniform_real_distribution<float> unit(-1, 1);
+		CompactPose::Vector                   range = { 30, 40, 50 };
+
+		for (int i = 0; i < 1000000; i++)
+		{
+			auto q = Normalized({ normal(a_rng), normal(a_rng), normal(a_rng), normal(a_rng) });
+			CompactPose::Vector position = { unit(a_rng) * range[0], unit(a_rng) * range[1],
+				unit(a_rng) * range[2] };
+			CheckPose(position, q, range, "random pose");
+
+			CompactPose::Quaternion negated = { -q[0], -q[1], -q[2], -q[3] };
+			Check(CompactPose::Encode(position, q, range) ==
+					  CompactPose::Encode(position, negated, range),
+				"q and -q encode the same");
+		}
+	}
+
+	/* Two or more components of about the same size: the rebuilt one must stay the largest */
+	void TestNearTies(std::mt19937& a_rng)
+	{
+		std::uniform_real_distribution<float> jitter(-1e-4f, 1e-4f);
+		std::uniform_int_distribution<int>    sign(0, 1);
+		auto signed_value = [&](float a_value) { return sign(a_rng) ? a_value : -a_value; };
+
+		for (int i = 0; i < 200000; i++)
+		{
+			// every pair of components at about 1/sqrt(2)
+			for (int a = 0; a < 4; a++)
+			{
+				for (int b = a + 1; b < 4; b++)
+				{
+					CompactPose::Quaternion q = { jitter(a_rng), jitter(a_rng), jitter(a_rng),
+						jitter(a_rng) };
+					q[a] = signed_value(0.7071068f + jitter(a_rng));
+					q[b] = signed_value(0.7071068f + jitter(a_rng));
+					CheckPose({}, Normalized(q), { 1, 1, 1 }, "two-way tie");
+				}
+			}
+
+			// three components at about 1/sqrt(3)
+			int                     odd = i % 4;
+			CompactPose::Quaternion q3;
+			for (int c = 0; c < 4; c++)
+			{
+				q3[c] = c == odd ? jitter(a_rng) : signed_value(0.5773503f + jitter(a_rng));
+			}
+			CheckPose({}, Normalized(q3), { 1, 1, 1 }, "three-way tie");
+
+			// all four at 1/2
+			CompactPose::Quaternion q4;
+			for (auto& c : q4) { c = signed_value(0.5f + jitter(a_rng)); }
+			CheckPose({}, Normalized(q4), { 1, 1, 1 }, "four-way tie");
+		}
+
+		// exact ties, no jitter
+		CheckPose({}, { 0.5f, 0.5f, 0.5f, 0.5f }, { 1, 1, 1 }, "exact four-way tie");
+		CheckPose({}, { 0.5f, -0.5f, 0.5f, -0.5f }, { 1, 1, 1 }, "exact four-way tie, signs");
+		CheckPose({}, Normalized({ 1, 1, 0, 0 }), { 1, 1, 1 }, "exact two-way tie");
+		CheckPose({}, Normalized({ 0, 0, -1, 1 }), { 1, 1, 1 }, "exact two-way tie, signs");
+	}
+
+	void TestRangeEdges()
+	{
+		CompactPose::Vector     range = { 30, 40, 50 };
+		CompactPose::Quaternion identity = { 0, 0, 0, 1 };
+
+		CheckPose(range, identity, range, "position at +range");
+		CheckPose({ -range[0], -range[1], -range[2] }, identity, range, "position at -range");
+
+		auto pose = CompactPose::Encode(range, identity, range);
+		Check(pose.position[0] == 32767 && pose.position[1] == 32767 && pose.position[2] == 32767,
+			"+range encodes to the largest step");
+		Check(pose.DecodePosition(range) == range, "+range decodes exactly");
+
+		auto outside = CompactPose::Encode({ 1000, -1000, 1e30f }, identity, range);
+		Check(outside.position[0] == 32767 && outside.position[1] == -32767 &&
+				  outside.position[2] == 32767,
+			"positions outside the range are clamped");
+		Check(ReEncodes(outside, range), "clamped position re-encodes");
+
+		auto no_range = CompactPose::Encode({ 5, 5, 5 }, identity, { 0, 0, 0 });
+		Check(no_range.position[0] == 0 && no_range.position[1] == 0 && no_range.position[2] == 0,
+			"zero range encodes position 0");
+		Check(ReEncodes(no_range, { 0, 0, 0 }), "zero range re-encodes");
+
+		CheckPose({ 1e-3f, -1e-3f, 0 }, identity, { 1e-3f, 1e-3f, 1e-3f }, "tiny range");
+		CheckPose({ 9000, -9000, 0 }, identity, { 1e4f, 1e4f, 1e4f }, "large range");
+
+		// every position step, on every axis
+		for (int step = -32767; step <= 32767; step++)
+		{
+			CompactPose stepped;
+			stepped.position[step & 1 ? 0 : 2] = (int16_t)step;
+			stepped.position[1] = (int16_t)-step;
+			Check(ReEncodes(stepped, range), "every position step re-encodes");
+		}
+	}
+
+	/* Any rotation bits Encode can produce decode to a quaternion that encodes back to the same
+	 * bits, including component sets that aren't a unit quaternion */
+	void TestRotationBits(std::mt19937& a_rng)
+	{
+		// Encode clamps components to [-kComponentLimit, kComponentLimit], so the largest code
+		// is 2 * kComponentZero
+		std::uniform_int_distribution<uint64_t> index(0, 3);
+		std::uniform_int_distribution<uint64_t> component(0, CompactPose::kComponentZero * 2);
+		std::uniform_int_distribution<int>      edge(0, 3);
+		auto random_component = [&]() {
+			// bias toward the ends of the range, where the rebuilt component can lose the lead
+			switch (edge(a_rng))
+			{
+			case 0:
+				return (uint64_t)0;
+			case 1:
+				return CompactPose::kComponentZero * 2;
+			default:
+				return component(a_rng);
+			}
+		};
+
+		for (int i = 0; i < 1000000; i++)
+		{
+			auto value = index(a_rng);
+			for (int c = 0; c < 3; c++)
+			{
+				value = value << CompactPose::kComponentBits | random_component();
+			}
+
+			CompactPose pose;
+			pose.rotation[0] = (uint16_t)(value >> 32);
+			pose.rotation[1] = (uint16_t)(value >> 16);
+			pose.rotation[2] = (uint16_t)value;
+			Check(ReEncodes(pose, { 1, 1, 1 }), "any rotation bits re-encode");
+		}
+
+		// the spare top bit doesn't pick a component outside the quaternion
+		CompactPose spare;
+		spare.rotation[0] |= 0x8000;
+		auto q = spare.DecodeRotation();
+		Check(q[3] == 1, "spare bit is ignored");
+	}
+
+	int Benchmark()
+	{
+		constexpr std::size_t kCount = 1 << 20;
+		constexpr int         kRounds = 10;
+
+		std::mt19937                          rng(7);
+		std::normal_distribution<float>       normal;
+		std::uniform_real_distribution<float> unit(-1, 1);
+		CompactPose::Vector                   range = { 30, 40, 50 };
+
+		std::vector<CompactPose::Quaternion> rotations(kCount);
+		std::vector<CompactPose::Vector>     positions(kCount);
+		std::vector<CompactPose>             poses(kCount);
+		for (std::size_t i = 0; i < kCount; i++)
+		{
+			rotations[i] = Normalized({ normal(rng), normal(rng), normal(rng), normal(rng) });
+			positions[i] = { unit(rng) * range[0], unit(rng) * range[1], unit(rng) * range[2] };
+		}
+
+		using clock = std::chrono::steady_clock;
+		double encode_ns = 1e30, decode_ns = 1e30;
+		float  sink = 0;
+		for (int round = 0; round < kRounds; round++)
+		{
+			auto start = clock::now();
+			for (std::size_t i = 0; i < kCount; i++)
+			{
+				poses[i] = CompactPose::Encode(positions[i], rotations[i], range);
+			}
+			auto encoded = clock::now();
+			for (std::size_t i = 0; i < kCount; i++)
+			{
+				auto q = poses[i].DecodeRotation();
+				auto p = poses[i].DecodePosition(range);
+				sink += q[0] + p[0];
+			}
+			auto decoded = clock::now();
+
+			encode_ns = std::min(encode_ns,
+				std::chrono::duration<double, std::nano>(encoded - start).count() / kCount);
+			decode_ns = std::min(decode_ns,
+				std::chrono::duration<double, std::nano>(decoded - encoded).count() / kCount);
+		}
+
+		// best of kRounds, sink keeps the decode loop from being optimized out
+		std::printf("encode: %.1f ns/pose, %.1f M poses/s\n", encode_ns, 1e3 / encode_ns);
+		std::printf("decode: %.1f ns/pose, %.1f M poses/s (%g)\n", decode_ns, 1e3 / decode_ns,
+			sink);
+		return 0;
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && std::strcmp(argv[1], "--bench") == 0) { return Benchmark(); }
+
+	std::mt19937 rng(1);
+	TestIdentity();
+	TestRandom(rng);
+	TestNearTies(rng);
+	TestRangeEdges();
+	TestRotationBits(rng);
+
+	if (failures)
+	{
+		std::printf("%d checks failed\n", failures);
+		return 1;
+	}
+	std::printf("all checks passed\n");
+	return 0;
+}
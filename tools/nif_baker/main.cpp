@@ -0,0 +1,145 @@
+/* Bakes the NIF index the plugin reads at startup, see include/nif_index.h.
+ *
+ * Usage: nif_baker <meshes folder> <output file>
+ */
+#include "nif_file.h"
+#include "nif_index.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+	struct Entry
+	{
+		std::string         path;
+		nifbaker::ModelInfo info;
+	};
+
+	uint32_t AddString(std::string& a_table, std::string_view a_str)
+	{
+		auto offset = (uint32_t)a_table.size();
+		a_table.append(a_str);
+		a_table.push_back('\0');
+		return offset;
+	}
+
+	std::size_t Align(std::size_t a_offset) { return (a_offset + 7) & ~std::size_t(7); }
+
+	bool WriteIndex(const std::filesystem::path& a_file, std::vector<Entry>& a_entries)
+	{
+		for (auto& entry : a_entries) { entry.path = nifindex::NormalizePath(entry.path); }
+		std::sort(a_entries.begin(), a_entries.end(), [](const Entry& a, const Entry& b) {
+			return nifindex::HashPath(a.path) < nifindex::HashPath(b.path);
+		});
+
+		std::vector<nifindex::ModelRecord> models;
+		std::vector<nifindex::ViewRecord>  views;
+		std::string                        strings;
+		for (auto& [path, info] : a_entries)
+		{
+			nifindex::ModelRecord model;
+			model.path_hash = nifindex::HashPath(path);
+			model.path = AddString(strings, path);
+			model.first_view = (uint32_t)views.size();
+			model.view_count = (uint32_t)info.views.size();
+			if (info.bound.radius >= 0)
+			{
+				model.center[0] = info.bound.center.x;
+				model.center[1] = info.bound.center.y;
+				model.center[2] = info.bound.center.z;
+				model.radius = info.bound.radius;
+				model.extents[0] = (info.box_max.x - info.box_min.x) * 0.5f;
+				model.extents[1] = (info.box_max.y - info.box_min.y) * 0.5f;
+				model.extents[2] = (info.box_max.z - info.box_min.z) * 0.5f;
+			}
+			models.push_back(model);
+
+			for (auto& node : info.views)
+			{
+				nifindex::ViewRecord view;
+				view.name = AddString(strings, node.name);
+				view.translate[0] = node.translate.x;
+				view.translate[1] = node.translate.y;
+				view.translate[2] = node.translate.z;
+				view.extent[0] = node.extent.x;
+				view.extent[1] = node.extent.y;
+				view.extent[2] = node.extent.z;
+				views.push_back(view);
+			}
+		}
+
+		nifindex::Header header;
+		header.model_count = (uint32_t)models.size();
+		header.models_offset = (uint32_t)Align(sizeof(header));
+		header.view_count = (uint32_t)views.size();
+		header.views_offset =
+			(uint32_t)Align(header.models_offset + models.size() * sizeof(nifindex::ModelRecord));
+		header.strings_offset =
+			(uint32_t)Align(header.views_offset + views.size() * sizeof(nifindex::ViewRecord));
+		header.strings_size = (uint32_t)strings.size();
+
+		std::vector<char> out(header.strings_offset + strings.size(), 0);
+		std::memcpy(out.data(), &header, sizeof(header));
+		std::memcpy(out.data() + header.models_offset, models.data(),
+			models.size() * sizeof(nifindex::ModelRecord));
+		std::memcpy(out.data() + header.views_offset, views.data(),
+			views.size() * sizeof(nifindex::ViewRecord));
+		std::memcpy(out.data() + header.strings_offset, strings.data(), strings.size());
+
+		std::ofstream file(a_file, std::ios::binary | std::ios::trunc);
+		return file.write(out.data(), out.size()) && file.flush();
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	if (argc != 3)
+	{
+		std::cerr << "usage: nif_baker <meshes folder> <output file>\n";
+		return 2;
+	}
+
+	std::filesystem::path meshes = argv[1];
+	std::error_code       error;
+	if (!std::filesystem::is_directory(meshes, error))
+	{
+		std::cerr << "not a folder: " << meshes << "\n";
+		return 2;
+	}
+
+	std::vector<Entry> entries;
+	int                failed = 0;
+	for (auto& file : std::filesystem::recursive_directory_iterator(meshes, error))
+	{
+		auto extension = file.path().extension().string();
+		std::transform(extension.begin(), extension.end(), extension.begin(),
+			[](char c) { return (char)std::tolower((unsigned char)c); });
+		if (!file.is_regular_file() || extension != ".nif") { continue; }
+
+		nifbaker::NifFile nif;
+		std::string       reason;
+		if (!nif.Load(file.path(), reason))
+		{
+			std::cerr << file.path().string() << ": " << reason << "\n";
+			failed++;
+			continue;
+		}
+
+		auto info = nif.GetModelInfo();
+		if (info.bound.radius < 0 && info.views.empty()) { continue; }
+
+		entries.push_back(
+			{ std::filesystem::relative(file.path(), meshes).make_preferred().string(), info });
+	}
+
+	if (!WriteIndex(argv[2], entries))
+	{
+		std::cerr << "can't write " << argv[2] << "\n";
+		return 1;
+	}
+	std::cout << entries.size() << " models indexed, " << failed << " files skipped\n";
+	return 0;
+}
@@ -0,0 +1,383 @@
+#include "nif_file.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <fstream>
+
+namespace nifbaker
+{
+	namespace
+	{
+		constexpr uint32_t    kVersion20207 = 0x14020007;
+		constexpr const char* kHeaderPrefix = "Gamebryo File Format, Version ";
+		constexpr int         kMaxDepth = 64;
+
+		// direct children of the root with these names are Views, same as Backpack::Init
+		constexpr std::array kViewNames = { "Container", "Grid", "Holster", "GrabNode" };
+		constexpr const char* kExtentName = "extent";
+
+		bool IsNode(const std::string& a_type)
+		{
+			return a_type.ends_with("Node") || a_type == "BSDamageStage";
+		}
+
+		/* BSTriShape and its subclasses, which start with the same fields */
+		bool IsTriShape(const std::string& a_type)
+		{
+			return a_type.starts_with("BS") && a_type.ends_with("TriShape");
+		}
+
+		bool IsGeometry(const std::string& a_type)
+		{
+			return IsTriShape(a_type) || a_type == "NiTriShape" || a_type == "NiTriStrips";
+		}
+
+		Sphere Merge(const Sphere& a, const Sphere& b)
+		{
+			if (a.radius < 0) { return b; }
+			if (b.radius < 0) { return a; }
+
+			Vector3 d = { b.center.x - a.center.x, b.center.y - a.center.y,
+				b.center.z - a.center.z };
+			float dist = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+
+			if (dist + b.radius <= a.radius) { return a; }
+			if (dist + a.radius <= b.radius) { return b; }
+
+			float  radius = (dist + a.radius + b.radius) * 0.5f;
+			float  t = (radius - a.radius) / dist;
+			Sphere merged;
+			merged.center = { a.center.x + d.x * t, a.center.y + d.y * t, a.center.z + d.z * t };
+			merged.radius = radius;
+			return merged;
+		}
+	}
+
+	void NifFile::Reader::Skip(std::size_t a_bytes)
+	{
+		if (pos + a_bytes > data.size())
+		{
+			failed = true;
+			pos = data.size();
+		}
+		else { pos += a_bytes; }
+	}
+
+	std::string NifFile::Reader::ReadSizedString()
+	{
+		auto length = Read<uint32_t>();
+		if (pos + length > data.size())
+		{
+			failed = true;
+			return {};
+		}
+		std::string str((const char*)data.data() + pos, length);
+		pos += length;
+		return str;
+	}
+
+	std::string NifFile::Reader::ReadExportString()
+	{
+		auto length = Read<uint8_t>();
+		if (pos + length > data.size())
+		{
+			failed = true;
+			return {};
+		}
+		std::string str((const char*)data.data() + pos, length);
+		pos += length;
+		if (!str.empty() && str.back() == '\0') { str.pop_back(); }
+		return str;
+	}
+
+	Vector3 NifFile::Transform::Apply(const Vector3& a_point) const
+	{
+		float p[3] = { a_point.x * scale, a_point.y * scale, a_point.z * scale };
+		Vector3 out = translate;
+		out.x += rotate[0][0] * p[0] + rotate[0][1] * p[1] + rotate[0][2] * p[2];
+		out.y += rotate[1][0] * p[0] + rotate[1][1] * p[1] + rotate[1][2] * p[2];
+		out.z += rotate[2][0] * p[0] + rotate[2][1] * p[1] + rotate[2][2] * p[2];
+		return out;
+	}
+
+	NifFile::Transform NifFile::Transform::operator*(const Transform& a_local) const
+	{
+		Transform out;
+		for (int r = 0; r < 3; r++)
+		{
+			for (int c = 0; c < 3; c++)
+			{
+				out.rotate[r][c] = rotate[r][0] * a_local.rotate[0][c] +
+					rotate[r][1] * a_local.rotate[1][c] + rotate[r][2] * a_local.rotate[2][c];
+			}
+		}
+		out.translate = Apply(a_local.translate);
+		out.scale = scale * a_local.scale;
+		return out;
+	}
+
+	bool NifFile::Load(const std::filesystem::path& a_path, std::string& a_error)
+	{
+		blocks.clear();
+		strings.clear();
+		roots.clear();
+
+		std::ifstream file(a_path, std::ios::binary);
+		if (!file.is_open())
+		{
+			a_error = "can't open file";
+			return false;
+		}
+		data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+		auto line_end = std::find(data.begin(), data.end(), (uint8_t)'\n');
+		if (line_end == data.end() ||
+			!std::string(data.begin(), line_end).starts_with(kHeaderPrefix))
+		{
+			a_error = "not a NIF file";
+			return false;
+		}
+
+		Reader reader{ data, (std::size_t)(line_end - data.begin()) + 1 };
+		auto   version = reader.Read<uint32_t>();
+		if (version != kVersion20207)
+		{
+			a_error = "unsupported NIF version";
+			return false;
+		}
+		if (reader.Read<uint8_t>() != 1)
+		{
+			a_error = "big endian NIF";
+			return false;
+		}
+
+		user_version = reader.Read<uint32_t>();
+		bs_version = 0;
+		auto num_blocks = reader.Read<uint32_t>();
+		if (user_version >= 10)
+		{
+			bs_version = reader.Read<uint32_t>();
+			reader.ReadExportString();  // author
+			if (bs_version > 130) { reader.Skip(4); }
+			reader.ReadExportString();  // process script
+			reader.ReadExportString();  // export script
+			if (bs_version == 130) { reader.ReadExportString(); }
+		}
+
+		std::vector<std::string> types(reader.Read<uint16_t>());
+		for (auto& type : types) { type = reader.ReadSizedString(); }
+
+		// counts from a corrupt header must not allocate more than the file could hold, each
+		// block takes at least its type index and size, each string its length
+		auto fits = [&](uint64_t a_count, std::size_t a_size) {
+			return a_count <= (data.size() - reader.pos) / a_size;
+		};
+		if (!fits(num_blocks, 6))
+		{
+			a_error = "corrupt block count";
+			return false;
+		}
+
+		blocks.resize(num_blocks);
+		for (auto& block : blocks)
+		{
+			std::size_t type = reader.Read<uint16_t>() & 0x7FFF;
+			if (type < types.size()) { block.type = types[type]; }
+		}
+		for (auto& block : blocks) { block.size = reader.Read<uint32_t>(); }
+
+		auto num_strings = reader.Read<uint32_t>();
+		if (!fits(num_strings, 4))
+		{
+			a_error = "corrupt string count";
+			return false;
+		}
+		strings.resize(num_strings);
+		reader.Skip(4);  // max string length
+		for (auto& str : strings) { str = reader.ReadSizedString(); }
+
+		reader.Skip(reader.Read<uint32_t>() * 4ull);  // groups
+
+		for (auto& block : blocks)
+		{
+			block.offset = (uint32_t)reader.pos;
+			reader.Skip(block.size);
+		}
+
+		// footer, a missing one just means the first block is the root
+		auto num_roots = reader.Read<uint32_t>();
+		if (fits(num_roots, 4)) { roots.resize(num_roots); }
+		for (auto& root : roots) { root = reader.Read<int32_t>(); }
+		if (roots.empty() && !blocks.empty()) { roots.push_back(0); }
+
+		if (reader.failed && blocks.empty())
+		{
+			a_error = "truncated header";
+			return false;
+		}
+		return true;
+	}
+
+	std::string NifFile::GetString(uint32_t a_index) const
+	{
+		return a_index < strings.size() ? strings[a_index] : std::string();
+	}
+
+	bool NifFile::ReadAVObject(Reader& a_reader, AVObject& a_out) const
+	{
+		a_out.name = GetString(a_reader.Read<uint32_t>());
+		a_out.extra_data.resize(a_reader.Read<uint32_t>());
+		if (a_out.extra_data.size() > a_reader.data.size()) { return false; }
+		for (auto& extra : a_out.extra_data) { extra = a_reader.Read<int32_t>(); }
+		a_reader.Skip(4);  // controller
+
+		a_reader.Skip(bs_version > 26 ? 4 : 2);  // flags
+		a_out.local.translate = a_reader.Read<Vector3>();
+		for (auto& row : a_out.local.rotate)
+		{
+			for (auto& each : row) { each = a_reader.Read<float>(); }
+		}
+		a_out.local.scale = a_reader.Read<float>();
+		if (bs_version <= 34) { a_reader.Skip(a_reader.Read<uint32_t>() * 4ull); }  // properties
+		a_reader.Skip(4);  // collision object
+
+		return !a_reader.failed;
+	}
+
+	Sphere NifFile::GetShapeBound(const Block& a_block, Reader& a_reader) const
+	{
+		Sphere bound;
+		if (IsTriShape(a_block.type))
+		{
+			bound.center = a_reader.Read<Vector3>();
+			bound.radius = a_reader.Read<float>();
+		}
+		else if (a_block.type == "NiTriShape" || a_block.type == "NiTriStrips")
+		{
+			auto data_ref = a_reader.Read<int32_t>();
+			if (data_ref < 0 || data_ref >= (int32_t)blocks.size()) { return bound; }
+
+			// NiGeometryData, the bound comes after the vertex arrays
+			Reader geom{ data, blocks[data_ref].offset };
+			geom.Skip(4);  // group id
+			auto num_vertices = geom.Read<uint16_t>();
+			geom.Skip(2);  // keep and compress flags
+			if (geom.Read<uint8_t>()) { geom.Skip(num_vertices * 12ull); }
+			auto vector_flags = geom.Read<uint16_t>();
+			if (user_version == 12) { geom.Skip(4); }  // material CRC
+			if (geom.Read<uint8_t>())
+			{
+				geom.Skip(num_vertices * 12ull);
+				if (vector_flags & 0x1000) { geom.Skip(num_vertices * 24ull); }  // tangents
+			}
+			bound.center = geom.Read<Vector3>();
+			bound.radius = geom.Read<float>();
+			if (geom.failed) { bound.radius = -1; }
+		}
+		if (a_reader.failed) { bound.radius = -1; }
+		return bound;
+	}
+
+	void NifFile::AddBounds(
+		int32_t a_block, const Transform& a_parent, ModelInfo& a_info, int a_depth) const
+	{
+		if (a_block < 0 || a_block >= (int32_t)blocks.size() || a_depth > kMaxDepth) { return; }
+
+		auto&    block = blocks[a_block];
+		Reader   reader{ data, block.offset };
+		AVObject object;
+
+		bool node = IsNode(block.type);
+		if (!node && !IsGeometry(block.type)) { return; }
+		if (!ReadAVObject(reader, object)) { return; }
+
+		// the root's own transform isn't part of the model's space
+		auto world = a_depth == 0 ? Transform() : a_parent * object.local;
+
+		if (node)
+		{
+			std::vector<int32_t> children(reader.Read<uint32_t>());
+			if (reader.failed || children.size() > blocks.size()) { return; }
+			for (auto& child : children) { child = reader.Read<int32_t>(); }
+
+			for (auto child : children) { AddBounds(child, world, a_info, a_depth + 1); }
+		}
+		else if (auto bound = GetShapeBound(block, reader); bound.radius >= 0)
+		{
+			Sphere placed;
+			placed.center = world.Apply(bound.center);
+			placed.radius = bound.radius * world.scale;
+			a_info.bound = Merge(a_info.bound, placed);
+
+			bool first = a_info.box_min.x > a_info.box_max.x;
+			auto& lo = a_info.box_min;
+			auto& hi = a_info.box_max;
+			auto& c = placed.center;
+			auto  r = placed.radius;
+			lo = { first ? c.x - r : std::min(lo.x, c.x - r),
+				first ? c.y - r : std::min(lo.y, c.y - r),
+				first ? c.z - r : std::min(lo.z, c.z - r) };
+			hi = { first ? c.x + r : std::max(hi.x, c.x + r),
+				first ? c.y + r : std::max(hi.y, c.y + r),
+				first ? c.z + r : std::max(hi.z, c.z + r) };
+		}
+	}
+
+	ModelInfo NifFile::GetModelInfo() const
+	{
+		ModelInfo info;
+		info.box_min = { 1, 1, 1 };  // inverted box, no bounds yet
+		info.box_max = { -1, -1, -1 };
+		if (roots.empty()) { return info; }
+
+		AddBounds(roots[0], Transform(), info, 0);
+
+		// Views are the root's direct children with a View name
+		auto& root = blocks[roots[0]];
+		if (!IsNode(root.type)) { return info; }
+
+		Reader   reader{ data, root.offset };
+		AVObject object;
+		if (!ReadAVObject(reader, object)) { return info; }
+
+		std::vector<int32_t> children(reader.Read<uint32_t>());
+		if (reader.failed || children.size() > blocks.size()) { return info; }
+		for (auto& child : children) { child = reader.Read<int32_t>(); }
+
+		for (auto child : children)
+		{
+			if (child < 0 || child >= (int32_t)blocks.size()) { continue; }
+
+			Reader   child_reader{ data, blocks[child].offset };
+			AVObject child_object;
+			if (!IsNode(blocks[child].type) || !ReadAVObject(child_reader, child_object))
+			{
+				continue;
+			}
+			auto is_view = [&](const char* name) {
+				return child_object.name.find(name) != std::string::npos;
+			};
+			if (std::none_of(kViewNames.begin(), kViewNames.end(), is_view)) { continue; }
+
+			ViewNode view;
+			view.name = child_object.name;
+			view.translate = child_object.local.translate;
+			for (auto extra : child_object.extra_data)
+			{
+				if (extra < 0 || extra >= (int32_t)blocks.size() ||
+					blocks[extra].type != "NiVectorExtraData")
+				{
+					continue;
+				}
+				Reader extra_reader{ data, blocks[extra].offset };
+				if (GetString(extra_reader.Read<uint32_t>()) == kExtentName)
+				{
+					view.extent = extra_reader.Read<Vector3>();
+				}
+			}
+			info.views.push_back(std::move(view));
+		}
+		return info;
+	}
+}
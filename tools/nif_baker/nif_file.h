@@ -0,0 +1,126 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace nifbaker
+{
+	struct Vector3
+	{
+		float x = 0;
+		float y = 0;
+		float z = 0;
+	};
+
+	struct Sphere
+	{
+		Vector3 center;
+		float   radius = -1;  // negative if empty
+	};
+
+	struct ViewNode
+	{
+		std::string name;
+		Vector3     translate;
+		Vector3     extent;
+	};
+
+	/* What the plugin needs to know about a model, in its root node's space */
+	struct ModelInfo
+	{
+		Sphere                bound;
+		Vector3               box_min;
+		Vector3               box_max;
+		std::vector<ViewNode> views;
+	};
+
+	/** Reads the parts of a Skyrim NIF (20.2.0.7, SE/VR or LE) the plugin cares about: the
+	 * bounding spheres of the shapes under the root, and the View nodes directly below it.
+	 *
+	 * Only the block prefixes that hold those are parsed, everything else is skipped with the
+	 * block sizes from the header.
+	 */
+	class NifFile
+	{
+	public:
+		/* Returns: false if the file couldn't be read, a_error says why */
+		bool Load(const std::filesystem::path& a_path, std::string& a_error);
+
+		ModelInfo GetModelInfo() const;
+
+	private:
+		struct Transform
+		{
+			float   rotate[3][3] = { { 1, 0, 0 }, { 0, 1, 0 }, { 0, 0, 1 } };
+			Vector3 translate;
+			float   scale = 1;
+
+			Vector3   Apply(const Vector3& a_point) const;
+			Transform operator*(const Transform& a_local) const;
+		};
+
+		struct Block
+		{
+			std::string type;
+			uint32_t    offset = 0;
+			uint32_t    size = 0;
+		};
+
+		/* Cursor into data, reads past the end return zeroes and set failed */
+		struct Reader
+		{
+			const std::vector<uint8_t>& data;
+			std::size_t                 pos = 0;
+			bool                        failed = false;
+
+			template <typename T>
+			T Read()
+			{
+				T value{};
+				if (pos + sizeof(T) > data.size())
+				{
+					failed = true;
+					pos = data.size();
+					return value;
+				}
+				std::memcpy(&value, data.data() + pos, sizeof(T));
+				pos += sizeof(T);
+				return value;
+			}
+
+			void Skip(std::size_t a_bytes);
+
+			std::string ReadSizedString();  // uint32 length
+			std::string ReadExportString();  // uint8 length, includes the null
+		};
+
+		/* NiObjectNET and NiAVObject fields, shared by nodes and shapes */
+		struct AVObject
+		{
+			std::string          name;
+			std::vector<int32_t> extra_data;
+			Transform            local;
+		};
+
+		bool ReadAVObject(Reader& a_reader, AVObject& a_out) const;
+
+		std::string GetString(uint32_t a_index) const;
+
+		/* Merges the bounds of a_block and its children into a_info */
+		void AddBounds(int32_t a_block, const Transform& a_parent, ModelInfo& a_info,
+			int a_depth) const;
+
+		/* Returns: the shape's bound in its own space, with a negative radius if it has none */
+		Sphere GetShapeBound(const Block& a_block, Reader& a_reader) const;
+
+		std::vector<uint8_t>     data;
+		std::vector<Block>       blocks;
+		std::vector<std::string> strings;
+		std::vector<int32_t>     roots;
+		uint32_t                 user_version = 0;
+		uint32_t                 bs_version = 0;
+	};
+}
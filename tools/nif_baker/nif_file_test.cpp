@@ -0,0 +1,241 @@
+/* Tests for nifbaker::NifFile against small NIFs written here, see nif_file.h.
+ *
+ * Usage: nif_file_test  exit code 1 if any check failed
+ */
+#include "nif_file.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using nifbaker::NifFile;
+
+	int failures = 0;
+
+	void Check(bool a_ok, const char* a_what)
+	{
+		if (!a_ok)
+		{
+			std::printf("FAILED: %s\n", a_what);
+			failures++;
+		}
+	}
+
+	bool Near(float a, float b) { return std::abs(a - b) < 1e-4f; }
+
+	struct Bytes
+	{
+		std::vector<uint8_t> data;
+
+		template <typename T>
+		Bytes& Put(T a_value)
+		{
+			auto begin = reinterpret_cast<const uint8_t*>(&a_value);
+			data.insert(data.end(), begin, begin + sizeof(T));
+			return *this;
+		}
+
+		Bytes& PutSizedString(const std::string& a_str)
+		{
+			Put((uint32_t)a_str.size());
+			data.insert(data.end(), a_str.begin(), a_str.end());
+			return *this;
+		}
+
+		Bytes& PutExportString(const std::string& a_str)
+		{
+			Put((uint8_t)(a_str.size() + 1));
+			data.insert(data.end(), a_str.begin(), a_str.end());
+			return Put('\0');
+		}
+
+		Bytes& Append(const Bytes& a_other)
+		{
+			data.insert(data.end(), a_other.data.begin(), a_other.data.end());
+			return *this;
+		}
+	};
+
+	struct Block
+	{
+		std::string type;
+		Bytes       data;
+	};
+
+	/* A Skyrim NIF header and footer around a_blocks, the first block is the root */
+	struct NifBuilder
+	{
+		uint32_t                 user_version = 12;
+		uint32_t                 bs_version = 100;
+		std::vector<Block>       blocks;
+		std::vector<std::string> strings;
+		// written in place of the real counts if not 0
+		uint32_t num_blocks = 0;
+		uint32_t num_strings = 0;
+
+		/* NiObjectNET and NiAVObject fields */
+		Bytes AVObject(uint32_t a_name, float a_x, float a_y, float a_z) const
+		{
+			Bytes out;
+			out.Put(a_name).Put(0u).Put(-1);  // no extra data, no controller
+			if (bs_version > 26) { out.Put(14u); }
+			else { out.Put((uint16_t)14); }
+			out.Put(a_x).Put(a_y).Put(a_z);
+			for (int r = 0; r < 3; r++)
+			{
+				for (int c = 0; c < 3; c++) { out.Put(r == c ? 1.f : 0.f); }
+			}
+			out.Put(1.f);
+			if (bs_version <= 34) { out.Put(0u); }  // properties
+			return out.Put(-1);                      // collision object
+		}
+
+		Bytes Node(uint32_t a_name, const std::vector<int32_t>& a_children) const
+		{
+			auto out = AVObject(a_name, 0, 0, 0);
+			out.Put((uint32_t)a_children.size());
+			for (auto child : a_children) { out.Put(child); }
+			return out.Put(0u);  // effects
+		}
+
+		/* NiTriShapeData with three vertices and the given bound */
+		Bytes TriShapeData(float a_x, float a_y, float a_z, float a_radius) const
+		{
+			Bytes out;
+			out.Put(0).Put((uint16_t)3).Put((uint8_t)0).Put((uint8_t)0);
+			out.Put((uint8_t)1);
+			for (int i = 0; i < 9; i++) { out.Put((float)i); }
+			out.Put((uint16_t)0);
+			if (user_version == 12) { out.Put(0xDEADBEEFu); }  // material CRC
+			out.Put((uint8_t)0);  // no normals
+			out.Put(a_x).Put(a_y).Put(a_z).Put(a_radius);
+			return out.Put((uint8_t)0);  // no vertex colors
+		}
+
+		std::filesystem::path Write(const char* a_name) const
+		{
+			std::vector<std::string> types;
+			Bytes                    out;
+			out.data.assign(
+				{ 'G', 'a', 'm', 'e', 'b', 'r', 'y', 'o', ' ', 'F', 'i', 'l', 'e', ' ', 'F', 'o',
+					'r', 'm', 'a', 't', ',', ' ', 'V', 'e', 'r', 's', 'i', 'o', 'n', ' ', '2', '0',
+					'.', '2', '.', '0', '.', '7', '\n' });
+			out.Put(0x14020007u).Put((uint8_t)1).Put(user_version);
+			out.Put(num_blocks ? num_blocks : (uint32_t)blocks.size());
+			out.Put(bs_version).PutExportString("test").PutExportString("").PutExportString("");
+
+			std::vector<uint16_t> type_indices;
+			for (auto& block : blocks)
+			{
+				auto it = std::find(types.begin(), types.end(), block.type);
+				type_indices.push_back((uint16_t)(it - types.begin()));
+				if (it == types.end()) { types.push_back(block.type); }
+			}
+			out.Put((uint16_t)types.size());
+			for (auto& type : types) { out.PutSizedString(type); }
+			for (auto index : type_indices) { out.Put(index); }
+			for (auto& block : blocks) { out.Put((uint32_t)block.data.data.size()); }
+
+			out.Put(num_strings ? num_strings : (uint32_t)strings.size()).Put(64u);
+			for (auto& str : strings) { out.PutSizedString(str); }
+			out.Put(0u);  // groups
+
+			for (auto& block : blocks) { out.Append(block.data); }
+			out.Put(1u).Put(0);  // footer, block 0 is the root
+
+			auto path = std::filesystem::temp_directory_path() / a_name;
+			std::ofstream(path, std::ios::binary | std::ios::trunc)
+				.write((const char*)out.data.data(), out.data.size());
+			return path;
+		}
+	};
+
+	/* A root with one NiTriShape, placed at (10, 0, 0), whose data holds the bound */
+	NifBuilder TriShapeNif(uint32_t a_user_version, uint32_t a_bs_version)
+	{
+		NifBuilder nif;
+		nif.user_version = a_user_version;
+		nif.bs_version = a_bs_version;
+		nif.strings = { "Root", "Shape" };
+		nif.blocks.push_back({ "BSFadeNode", nif.Node(0, { 1 }) });
+		nif.blocks.push_back({ "NiTriShape", nif.AVObject(1, 10, 0, 0).Put(2) });
+		nif.blocks.push_back({ "NiTriShapeData", nif.TriShapeData(1, 2, 3, 5) });
+		return nif;
+	}
+
+	void CheckTriShape(const NifBuilder& a_nif, const char* a_file, const char* a_what)
+	{
+		NifFile     file;
+		std::string error;
+		Check(file.Load(a_nif.Write(a_file), error), a_what);
+
+		auto info = file.GetModelInfo();
+		Check(Near(info.bound.center.x, 11) && Near(info.bound.center.y, 2) &&
+				  Near(info.bound.center.z, 3) && Near(info.bound.radius, 5),
+			a_what);
+		Check(Near(info.box_min.x, 6) && Near(info.box_max.z, 8), a_what);
+	}
+
+	void TestTriShape()
+	{
+		CheckTriShape(TriShapeNif(12, 83), "nif_file_test_le.nif", "LE NiTriShape bound");
+		CheckTriShape(TriShapeNif(12, 100), "nif_file_test_se.nif", "SE NiTriShape bound");
+		CheckTriShape(TriShapeNif(11, 34), "nif_file_test_fo3.nif", "user version 11 bound");
+	}
+
+	void TestBSTriShape()
+	{
+		NifBuilder nif;
+		nif.strings = { "Root", "Shape" };
+		nif.blocks.push_back({ "BSFadeNode", nif.Node(0, { 1 }) });
+		nif.blocks.push_back(
+			{ "BSTriShape", nif.AVObject(1, 0, 0, 4).Put(1.f).Put(0.f).Put(0.f).Put(2.f) });
+
+		NifFile     file;
+		std::string error;
+		Check(file.Load(nif.Write("nif_file_test_bs.nif"), error), "BSTriShape loads");
+
+		auto info = file.GetModelInfo();
+		Check(Near(info.bound.center.x, 1) && Near(info.bound.center.z, 4) &&
+				  Near(info.bound.radius, 2),
+			"BSTriShape bound");
+	}
+
+	/* Counts too large for the file are rejected before anything is allocated for them */
+	void TestCorruptCounts()
+	{
+		NifFile     file;
+		std::string error;
+
+		auto nif = TriShapeNif(12, 83);
+		nif.num_blocks = 0xFFFFFFFF;
+		Check(!file.Load(nif.Write("nif_file_test_blocks.nif"), error), "huge block count");
+
+		nif = TriShapeNif(12, 83);
+		nif.num_strings = 0xFFFFFFFF;
+		Check(!file.Load(nif.Write("nif_file_test_strings.nif"), error), "huge string count");
+
+		nif = TriShapeNif(12, 83);
+		Check(file.Load(nif.Write("nif_file_test_valid.nif"), error), "file loads again");
+	}
+}
+
+int main()
+{
+	TestTriShape();
+	TestBSTriShape();
+	TestCorruptCounts();
+
+	if (failures)
+	{
+		std::printf("%d checks failed\n", failures);
+		return 1;
+	}
+	std::printf("all checks passed\n");
+	return 0;
+}